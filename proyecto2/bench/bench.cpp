@@ -0,0 +1,370 @@
+#include "../include/graph_reader.hpp"
+#include "../include/pso.hpp"
+#include "../include/prim_kernel.hpp"
+#include "../include/json.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+/**
+ * kmst_bench: micro y macrobenchmarks de las rutas críticas del solver.
+ *
+ * Cada caso se ejecuta `warmup` veces sin medir y `reps` veces medido. La
+ * preparación de cada repetición (copias del grafo, enjambres, etc.) no se
+ * mide. Los tiempos se reportan en ms por operación: si un caso agrupa
+ * varias operaciones por repetición (batch), se divide entre ellas.
+ *
+ * Todo lo aleatorio usa semillas fijas, así que dos corridas sobre el mismo
+ * árbol de código miden exactamente el mismo trabajo.
+ *
+ * Además de tiempos, la sección "quality" compara la búsqueda en precisión
+ * simple contra la de double con las mismas semillas: el peso del mejor
+ * conjunto de cada una, recalculado en double.
+ *
+ * Uso:
+ *   kmst_bench [--data DIR] [--reps N] [--warmup N] [--filter TEXTO]
+ *              [--datasets a.txt,b.txt] [--out archivo.json]
+ */
+
+namespace {
+
+struct Options {
+    std::string data_dir = "data";
+    std::vector<std::string> datasets = {"g3.txt", "g2.txt", "graph.txt"};
+    int reps = 5;
+    int warmup = 1;
+    std::string filter;
+    std::string out;
+};
+
+struct Param {
+    std::string name;
+    long long value;
+};
+
+struct Result {
+    std::string name;
+    std::string dataset;
+    std::vector<Param> params;
+    int batch;
+    std::vector<double> samples;   // ms por operación
+};
+
+// Pesos finales (en double) de las mismas semillas con dos configuraciones
+struct Quality {
+    std::string name;
+    std::string dataset;
+    std::vector<Param> params;
+    std::vector<double> reference;   // búsqueda en double
+    std::vector<double> variant;     // búsqueda en float, pesos recalculados
+};
+
+class Runner {
+public:
+    explicit Runner(const Options& opt) : opt_(opt) {}
+
+    /**
+     * Mide un caso. setup() prepara el estado de cada repetición (no se
+     * mide) y run(state) ejecuta `batch` operaciones sobre él.
+     */
+    template <class Setup, class Run>
+    void measure(const std::string& name, const std::string& dataset,
+                 std::vector<Param> params, int batch, Setup setup, Run run) {
+        if (!opt_.filter.empty() && name.find(opt_.filter) == std::string::npos)
+            return;
+
+        Result r{name, dataset, std::move(params), batch, {}};
+        for (int i = 0; i < opt_.warmup + opt_.reps; ++i) {
+            auto state = setup();
+            auto t0 = std::chrono::steady_clock::now();
+            run(state);
+            auto t1 = std::chrono::steady_clock::now();
+            if (i >= opt_.warmup)
+                r.samples.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count() / batch);
+        }
+
+        std::cerr << "  " << name << " [" << dataset << "]";
+        for (const Param& p : r.params) std::cerr << " " << p.name << "=" << p.value;
+        std::cerr << ": " << mean(r.samples) << " ms\n";
+        results_.push_back(std::move(r));
+    }
+
+    /** @return true si el filtro deja pasar el caso. */
+    bool selected(const std::string& name) const {
+        return opt_.filter.empty() || name.find(opt_.filter) != std::string::npos;
+    }
+
+    /** Registra una comparación de calidad (ver Quality). */
+    void record(Quality q) {
+        std::cerr << "  " << q.name << " [" << q.dataset << "]";
+        for (const Param& p : q.params) std::cerr << " " << p.name << "=" << p.value;
+        std::cerr << ": " << mean(q.reference) << " -> " << mean(q.variant)
+                  << " (" << 100.0 * relative_change(q) << "%)\n";
+        quality_.push_back(std::move(q));
+    }
+
+    void write(std::ostream& out) const {
+        JsonWriter w(out);
+        w.begin_object();
+        w.key("benchmark").value("kmst_bench");
+        w.key("threads").value(omp_get_max_threads());
+        w.key("isa").value(prim_kernel::isa());
+        w.key("warmup").value(opt_.warmup);
+        w.key("repetitions").value(opt_.reps);
+        w.key("unit").value("ms/op");
+        w.key("results").begin_array();
+        for (const Result& r : results_) {
+            std::vector<double> sorted = r.samples;
+            std::sort(sorted.begin(), sorted.end());
+
+            w.begin_object();
+            w.key("name").value(r.name);
+            w.key("dataset").value(r.dataset);
+            w.key("params").begin_object();
+            for (const Param& p : r.params) w.key(p.name).value(p.value);
+            w.end_object();
+            w.key("batch").value(r.batch);
+            w.key("samples").value(r.samples);
+            w.key("mean").value(mean(r.samples));
+            w.key("stddev").value(stddev(r.samples));
+            w.key("min").value(sorted.front());
+            w.key("median").value(sorted[sorted.size() / 2]);
+            w.key("max").value(sorted.back());
+            w.end_object();
+        }
+        w.end_array();
+
+        w.key("quality").begin_array();
+        for (const Quality& q : quality_) {
+            int better = 0, worse = 0;
+            for (size_t i = 0; i < q.reference.size(); ++i) {
+                if (q.variant[i] < q.reference[i]) ++better;
+                if (q.variant[i] > q.reference[i]) ++worse;
+            }
+
+            w.begin_object();
+            w.key("name").value(q.name);
+            w.key("dataset").value(q.dataset);
+            w.key("params").begin_object();
+            for (const Param& p : q.params) w.key(p.name).value(p.value);
+            w.end_object();
+            w.key("reference").value(q.reference);
+            w.key("variant").value(q.variant);
+            w.key("reference_mean").value(mean(q.reference));
+            w.key("variant_mean").value(mean(q.variant));
+            w.key("relative_change").value(relative_change(q));
+            w.key("better").value(better);
+            w.key("worse").value(worse);
+            w.end_object();
+        }
+        w.end_array();
+        w.end_object();
+    }
+
+private:
+    const Options& opt_;
+    std::vector<Result> results_;
+    std::vector<Quality> quality_;
+
+    static double relative_change(const Quality& q) {
+        return (mean(q.variant) - mean(q.reference)) / mean(q.reference);
+    }
+
+    static double mean(const std::vector<double>& xs) {
+        return std::accumulate(xs.begin(), xs.end(), 0.0) / xs.size();
+    }
+
+    // Desviación estándar muestral (n - 1)
+    static double stddev(const std::vector<double>& xs) {
+        if (xs.size() < 2) return 0.0;
+        double mu = mean(xs), s = 0.0;
+        for (double x : xs) s += (x - mu) * (x - mu);
+        return std::sqrt(s / (xs.size() - 1));
+    }
+};
+
+std::vector<std::vector<int>> random_subsets(int n, int k, int count, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<int> all(n);
+    std::iota(all.begin(), all.end(), 0);
+
+    std::vector<std::vector<int>> subsets(count);
+    for (auto& s : subsets) {
+        std::shuffle(all.begin(), all.end(), rng);
+        s.assign(all.begin(), all.begin() + k);
+    }
+    return subsets;
+}
+
+void bench_dataset(Runner& runner, const std::string& path, const std::string& name) {
+    // --- Lectura y preprocesamiento ---
+    runner.measure("graph_reader.from_file", name, {}, 1,
+        [] { return 0; },
+        [&](int) { Graph g = GraphReader::from_file(path); });
+
+    const Graph raw = GraphReader::from_file(path);
+    const int n = raw.num_vertices();
+    const int k_main = std::min(50, n);
+
+    runner.measure("graph.compute_distances", name, {{"n", n}}, 1,
+        [&] { return raw; },
+        [](Graph& g) { g.compute_distances(); });
+
+    Graph with_distances = raw;
+    with_distances.compute_distances();
+
+    runner.measure("graph.calcula_Normalizador", name, {{"k", k_main}}, 1,
+        [&] { return raw; },
+        [&](Graph& g) { g.calcula_Normalizador(k_main); });
+
+    runner.measure("graph.complete", name, {{"k", k_main}}, 1,
+        [&] { return with_distances; },
+        [&](Graph& g) { g.complete(k_main); });
+
+    Graph g = with_distances;
+    g.calcula_Normalizador(k_main);
+    g.complete(k_main);
+
+    // --- Prim sobre subconjuntos ---
+    for (int k : {10, 50, 100, 200}) {
+        if (k > n) continue;
+        const int batch = std::max(10, 20000 / k);
+        auto subsets = random_subsets(n, k, batch, 12345u + k);
+
+        runner.measure("graph.prim_subset", name, {{"k", k}}, batch,
+            [] { return 0; },
+            [&](int) {
+                volatile double sink = 0.0;
+                for (const auto& s : subsets) sink = sink + g.prim_subset(s);
+            });
+
+        runner.measure("graph.prim_subset_full", name, {{"k", k}}, batch,
+            [] { return 0; },
+            [&](int) {
+                volatile double sink = 0.0;
+                for (const auto& s : subsets) sink = sink + g.prim_subset_full(s).second;
+            });
+    }
+
+    // --- PSO ---
+    const int swarm = 20;
+    const int steps = 100;
+    runner.measure("pso.step", name, {{"k", k_main}, {"swarm", swarm}}, steps,
+        [&] {
+            auto pso = std::make_unique<PSO>(g, k_main, swarm, 1000, 0.6, 0.3, 7u);
+            pso->initialize();
+            return pso;
+        },
+        [&](std::unique_ptr<PSO>& pso) {
+            for (int i = 0; i < steps; ++i) pso->step();
+        });
+
+    const DenseMatrix32 single(g.adjacency());
+    runner.measure("pso.step_float32", name, {{"k", k_main}, {"swarm", swarm}}, steps,
+        [&] {
+            auto pso = std::make_unique<PSO>(g, k_main, swarm, 1000, 0.6, 0.3, 7u);
+            pso->set_single_precision(&single);
+            pso->initialize();
+            return pso;
+        },
+        [&](std::unique_ptr<PSO>& pso) {
+            for (int i = 0; i < steps; ++i) pso->step();
+        });
+
+    // sweep completo desde el gbest de una corrida corta (mismo punto de
+    // partida en cada repetición)
+    const int k_sweep = std::min(30, n);
+    runner.measure("pso.sweep", name, {{"k", k_sweep}, {"swarm", swarm}}, 1,
+        [&] {
+            auto pso = std::make_unique<PSO>(g, k_sweep, swarm, 200, 0.6, 0.3, 11u);
+            pso->initialize();
+            pso->run();
+            return pso;
+        },
+        [](std::unique_ptr<PSO>& pso) { pso->sweep(); });
+
+    // Calidad: corridas completas (run + sweep) con las mismas semillas en
+    // double y en float; el conjunto final se evalúa siempre en double
+    if (runner.selected("pso.float32_quality")) {
+        const int seeds = 8;
+        const int stagnation = 300;
+        for (int k : {10, k_main}) {
+            Quality q{"pso.float32_quality", name,
+                      {{"k", k}, {"swarm", swarm}, {"stagnation", stagnation}, {"seeds", seeds}},
+                      {}, {}};
+            for (unsigned seed = 1; seed <= (unsigned)seeds; ++seed) {
+                for (bool float32 : {false, true}) {
+                    PSO pso(g, k, swarm, stagnation, 0.6, 0.3, seed);
+                    if (float32) pso.set_single_precision(&single);
+                    pso.initialize();
+                    pso.run();
+                    pso.sweep();
+                    const double exact = g.prim_subset_full(pso.best_set()).second;
+                    (float32 ? q.variant : q.reference).push_back(exact);
+                }
+            }
+            runner.record(std::move(q));
+        }
+    }
+}
+
+void print_usage(const char* prog) {
+    std::cerr << "Uso: " << prog << " [--data DIR] [--reps N] [--warmup N] [--filter TEXTO]\n"
+              << "                  [--datasets a.txt,b.txt] [--out archivo.json]\n";
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--data" && i + 1 < argc) {
+            opt.data_dir = argv[++i];
+        } else if (arg == "--reps" && i + 1 < argc) {
+            opt.reps = std::max(1, std::stoi(argv[++i]));
+        } else if (arg == "--warmup" && i + 1 < argc) {
+            opt.warmup = std::max(0, std::stoi(argv[++i]));
+        } else if (arg == "--filter" && i + 1 < argc) {
+            opt.filter = argv[++i];
+        } else if (arg == "--datasets" && i + 1 < argc) {
+            opt.datasets.clear();
+            std::stringstream list(argv[++i]);
+            for (std::string item; std::getline(list, item, ',');)
+                if (!item.empty()) opt.datasets.push_back(item);
+        } else if (arg == "--out" && i + 1 < argc) {
+            opt.out = argv[++i];
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+
+    Runner runner(opt);
+    for (const std::string& name : opt.datasets) {
+        std::cerr << name << "\n";
+        bench_dataset(runner, opt.data_dir + "/" + name, name);
+    }
+
+    if (opt.out.empty()) {
+        runner.write(std::cout);
+    } else {
+        std::ofstream out(opt.out);
+        if (!out.is_open()) {
+            std::cerr << "No se pudo escribir " << opt.out << "\n";
+            return 1;
+        }
+        runner.write(out);
+    }
+    return 0;
+}
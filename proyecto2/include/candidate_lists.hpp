@@ -0,0 +1,35 @@
+#pragma once
+#include "graph.hpp"
+#include <vector>
+
+/**
+ * Clase CandidateLists
+ * Para cada vértice, sus m vecinos más cercanos según la matriz completada
+ * (Graph::adjacency() después de complete(k)).
+ *
+ * Un vértice lejano a todo el conjunto actual no puede mejorar su MST, así
+ * que la búsqueda restringe las propuestas aleatorias y el vecindario de
+ * intercambios a la unión de las listas de los vértices del conjunto.
+ *
+ * Las listas se guardan en un solo arreglo plano de n * m enteros, ordenadas
+ * por peso (empates por ID).
+ */
+class CandidateLists {
+public:
+    /**
+     * Construye las listas en paralelo (una fila de la matriz por vértice).
+     * @param graph grafo ya completado
+     * @param m vecinos por vértice (se acota a n - 1)
+     */
+    CandidateLists(const Graph& graph, int m);
+
+    /** @return número de vecinos por vértice. */
+    int size() const { return m_; }
+
+    /** @return los size() vecinos más cercanos de v, del más cercano al más lejano. */
+    const int* of(int v) const { return lists_.data() + (size_t)v * m_; }
+
+private:
+    int m_;
+    std::vector<int> lists_;
+};
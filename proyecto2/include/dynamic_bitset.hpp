@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <algorithm>
+#include <vector>
+
+/**
+ * Clase DynamicBitset
+ * Conjunto de enteros en [0, n) como arreglo de bits: pertenencia,
+ * inserción y borrado en O(1) sin reservar memoria después de resize().
+ */
+class DynamicBitset {
+public:
+    DynamicBitset() = default;
+    explicit DynamicBitset(int n) { resize(n); }
+
+    /** Ajusta el universo a [0, n) y vacía el conjunto. */
+    void resize(int n) { words_.assign((n + 63) / 64, 0); }
+
+    /** Vacía el conjunto (conserva la memoria). */
+    void clear() { std::fill(words_.begin(), words_.end(), 0); }
+
+    bool test(int i) const { return (words_[i >> 6] >> (i & 63)) & 1; }
+    void set(int i) { words_[i >> 6] |= std::uint64_t(1) << (i & 63); }
+    void reset(int i) { words_[i >> 6] &= ~(std::uint64_t(1) << (i & 63)); }
+
+private:
+    std::vector<std::uint64_t> words_;
+};
@@ -7,34 +7,95 @@
 #include <utility>
 #include <unordered_map>
 #include <queue>
+#include "matrix.hpp"
 
 
 /**
  * Clase Graph
  * Representa un grafo no dirigido y ponderado mediante matriz de adyacencia.
  * adj[i][j] almacena el peso de la arista entre i y j, o +inf si no hay arista.
+ * Las matrices son DenseMatrix: un bloque contiguo y alineado, sin indirección
+ * por fila, que es lo que domina el costo de prim_subset en n grandes.
+ *
+ * UNA SOLA MATRIZ:
+ * ----------------
+ * El preprocesamiento trabaja en el lugar sobre adj, que pasa por tres
+ * estados:
+ *
+ *   Original   pesos leídos (+inf sin arista)
+ *   Distances  caminos mínimos; las aristas originales quedan en edges()
+ *   Completed  f(u,v) de complete(k): distancias escaladas y, encima,
+ *              los pesos de las aristas originales
+ *
+ * Las aristas originales ocupan O(m), así que en ningún momento hay dos
+ * matrices n×n del mismo grafo; el normalizador recorre esa lista con un
+ * top-k acotado en vez de copiar los pesos.
  */
 class Graph {
 public:
-    using Matrix = std::vector<std::vector<double>>;
+    using Matrix = DenseMatrix;
+
+    /** Arista original (u < v). */
+    struct Edge {
+        int u;
+        int v;
+        double w;
+    };
+
+    enum class State { Original, Distances, Completed };
 
 private:
     int n;              // número de vértices
     int m;              // número de aristas
     Matrix adj;       
     double diameter_;   
-    Matrix distances_;
+    State state_;
+    std::vector<Edge> edges_;   // aristas originales, ordenadas por (u, v); vacía en Original
     double normalizador_;  
     double dist_normalizador_;
 
     std::unordered_map<std::string, int> vertex_to_id;
     std::vector<std::string> id_to_vertex;
 
+    double compute_diameter() const;
+
+    // Copia las aristas finitas del triángulo superior de adj a edges_
+    void record_edges();
+
+    // Peso de la arista original (u, v), o +inf si no existe
+    double original_weight(int u, int v) const;
+
+    // Suma de los k - 1 mayores pesos originales (top-k acotado, sin copiar)
+    double heaviest_sum(int k) const;
+
+    // --- Caminos mínimos ---
+    // Solo a través de compute_distances(), que guarda antes las aristas
+    // originales y marca el estado Distances; sueltos dejarían edges_ y
+    // state_ desfasados de adj. Los tres escriben las distancias en adj y
+    // actualizan diameter_.
+
+    // Floyd–Warshall en el lugar; solo reserva un bloque de filas pivote
+    void floyd_warshall();
+
+    // Dijkstra desde cada vértice (en paralelo) sobre CSR con RadixHeap;
+    // O(n·m) en la práctica, conviene cuando m es mucho menor que n²
+    void dijkstra_all_pairs();
+
+    // Elige Dijkstra para gráficas dispersas y Floyd–Warshall para densas
+    void shortest_paths();
+
+    friend class GraphCache;
+
 public:
     // --- Constructores ---
     Graph();
     explicit Graph(int n);
 
+    /**
+     * Crea un grafo sin aristas con los vértices dados; el ID de cada
+     * vértice es su posición. La matriz se reserva una sola vez.
+     */
+    explicit Graph(std::vector<std::string> names);
 
     // --- Métodos de construcción ---
     /**
@@ -42,6 +103,11 @@ public:
      * Si los vértices no existen, los crea automáticamente.
      */
     void add_edge(const std::string& u, const std::string& v, double w);
+
+    /**
+     * Agrega una arista entre dos vértices ya existentes, por ID interno.
+     */
+    void add_edge(int u, int v, double w);
     
     /**
      * Obtiene o crea el ID interno de un vértice.
@@ -68,7 +134,15 @@ public:
     bool has_edge(const std::string& u, const std::string& v) const;
     double getNormalizador() const { return normalizador_; }
     const Matrix& adjacency() const { return adj; }
-    const Matrix& distances() const { return distances_; }
+    State state() const { return state_; }
+
+    /** Distancias mínimas: la misma matriz que adjacency() en el estado Distances. */
+    const Matrix& distances() const { return adj; }
+    bool has_distances() const { return state_ == State::Distances; }
+
+    /** Aristas originales; disponibles desde compute_distances(). */
+    const std::vector<Edge>& edges() const { return edges_; }
+    const std::vector<std::string>& vertex_names() const { return id_to_vertex; }
 
     // --- Información general ---
     /** @return número de vértices del grafo. */
@@ -80,32 +154,52 @@ public:
     /** @return el diámetro del grafo (longitud máxima de los caminos mínimos). */
     double diameter() const { return diameter_; }
 
+    /**
+     * @return true si todos los vértices se alcanzan desde el vértice 0.
+     * Requiere caminos mínimos (estado Distances o Completed): en ambos un
+     * par desconectado queda en +inf.
+     */
+    bool connected() const;
+
     // --- Utilidades ---
     /** Imprime una representación de la gráfica. */
     void print() const;
 
     // --- Algoritmos ---
     /**
-     * Algoritmo de Floyd–Warshall.
-     * Calcula la matriz de distancias mínimas entre todos los pares de vértices.
-     * 
-     * @return matriz de distancias mínimas.
+     * Guarda las aristas originales y reemplaza adj por las distancias
+     * mínimas (estado Distances). No hace nada si ya se calcularon (por
+     * ejemplo, cargadas desde GraphCache).
      */
-    Matrix floyd_warshall();
+    void compute_distances();
 
     /**
-     * Completa la matriz de adyacencias usando la función de costo:
+     * Completa la matriz de adyacencias, en el lugar, usando la función de
+     * costo:
      * 
      *      f(u,v) = w(u,v)             si u y v son adyacentes
      *             = d(u,v) * diameter  en otro caso
      * 
      * donde d(u,v) es la distancia mínima entre u y v obtenida
-     * por Floyd–Warshall. Debe ejecutarse después de floyd_warshall().
+     * con compute_distances(). Después ya no hay distancias: para varios k
+     * conviene completed(k).
      */
     void complete(int k);
 
+    /**
+     * Copia completada y normalizada para k sin modificar este grafo, que
+     * queda como base independiente de k (aristas originales + distancias).
+     * Equivale a calcula_Normalizador(k) + complete(k) sobre una copia, en
+     * una sola pasada O(n²): la copia lleva una matriz, nombres, aristas
+     * originales y diámetro.
+     *
+     * @throws std::runtime_error si aún no se llamó compute_distances()
+     */
+    Graph completed(int k) const;
+
     /**
      * Calcula el normalizador, definido como la suma de los k - 1 mayores pesos
+     * de las aristas originales (válido en cualquier estado).
      * @param k tamaño del conjunto a considerar
      */
     void calcula_Normalizador(int k);
@@ -128,48 +222,11 @@ public:
      * @param vertex_subset Vector de IDs internos de vértices a incluir.
      * @return par (string con aristas, peso total del MST).
      */
-        // Versión rápida: solo retorna peso (usada en PSO)
-    inline double prim_subset(const std::vector<int>& vertex_subset) const {
-        const double INF = std::numeric_limits<double>::infinity();
-        if (vertex_subset.empty())
-            return INF;
-
-        const int k = vertex_subset.size();
-        double total = 0.0;
-
-        std::vector<char> in_mst(k, 0);
-        std::vector<double> min_edge(k, INF);
-
-        // Lineal para k pequeños — más estable y rápido
-        if (k <= 64) {
-            min_edge[0] = 0.0;
-            for (int i = 0; i < k; ++i) {
-                int u_local = -1;
-                double best = INF;
-                for (int v = 0; v < k; ++v)
-                    if (!in_mst[v] && min_edge[v] < best)
-                        best = min_edge[v], u_local = v;
-
-                if (u_local == -1) break;
-
-                in_mst[u_local] = 1;
-                total += best;
-
-                int u_global = vertex_subset[u_local];
-                for (int v_local = 0; v_local < k; ++v_local) {
-                    if (!in_mst[v_local]) {
-                        int v_global = vertex_subset[v_local];
-                        double w = adj[u_global][v_global];
-                        if (w < min_edge[v_local])
-                            min_edge[v_local] = w;
-                    }
-                }
-            }
-            return total;
-        }
-        return std::numeric_limits<double>::infinity(); // Return inalcanzable pero el compilador no lo sabe asi que evita warning
-
-    }
+        // Versión rápida: solo retorna peso (usada en PSO).
+        // Prim denso O(k²) para cualquier k; los buffers de trabajo son
+        // thread_local, por lo que no reserva memoria en llamadas sucesivas.
+        // Si el subconjunto no es conexo retorna +inf (prim_subset_full también).
+    double prim_subset(const std::vector<int>& vertex_subset) const;
 
     std::pair<std::vector<int>, double> prim_subset_full(const std::vector<int>& vertex_subset) const;
 
@@ -0,0 +1,65 @@
+#pragma once
+#include "graph.hpp"
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/**
+ * Clase GraphCache
+ * Caché binaria (.kmstbin) de un grafo ya preprocesado: nombres de los
+ * vértices, lista de aristas originales, matriz de distancias y diámetro.
+ * Evita repetir la lectura del texto y los caminos mínimos en corridas
+ * sucesivas sobre el mismo archivo.
+ *
+ * FORMATO (versión 2, little-endian):
+ * -----------------------------------
+ *   Header                       (ver struct Header)
+ *   nombres: n × (uint32 longitud, bytes), relleno a múltiplo de 8
+ *   aristas: edges × (uint32 u, uint32 v, double w), u < v, ordenadas
+ *   distancias: n × n doubles, row-major
+ *
+ * La versión 1 guardaba también la matriz de adyacencia original; se
+ * descarta y se regenera.
+ *
+ * La caché guarda el tamaño y el checksum (FNV-1a de 64 bits) del archivo
+ * fuente; si este cambia, la caché se considera inválida.
+ */
+class GraphCache {
+public:
+    static constexpr std::uint32_t VERSION = 2;
+
+    /** @return ruta de la caché asociada a un archivo fuente ("<fuente>.kmstbin"). */
+    static std::string path_for(const std::string& source);
+
+    /**
+     * Escribe la caché de un grafo cuyas distancias ya fueron calculadas.
+     * @param g grafo leído de source, con compute_distances() aplicado
+     * @param source archivo de texto del que proviene el grafo
+     * @param cache_path ruta de salida
+     * @throws std::runtime_error si no se puede escribir o faltan distancias
+     */
+    static void write(const Graph& g, const std::string& source, const std::string& cache_path);
+
+    /**
+     * Carga la caché si existe y corresponde al archivo fuente actual.
+     * @return el grafo con distancias y diámetro, o std::nullopt si la
+     *         caché no existe, es de otra versión o está desactualizada.
+     */
+    static std::optional<Graph> load(const std::string& source, const std::string& cache_path);
+
+    /** Checksum FNV-1a de 64 bits. */
+    static std::uint64_t checksum(const char* data, std::size_t size);
+
+private:
+    struct Header {
+        char magic[8];
+        std::uint32_t version;
+        std::uint32_t n;
+        std::uint64_t m;
+        std::uint64_t edges;          // aristas distintas (m cuenta las líneas leídas)
+        std::uint64_t source_size;
+        std::uint64_t source_hash;
+        double diameter;
+        std::uint64_t names_bytes;
+    };
+};
@@ -8,11 +8,17 @@
  * Clase GraphReader
  * Lee una gráfica a partir de un archivo o cadena de texto
  * en formato "u,v,w;u,v,w;..." sin indicar tamaño explícito.
+ * Los registros se separan con ';' o salto de línea.
+ *
+ * La lectura se hace en una sola pasada: los nombres se internan como
+ * vistas sobre el texto y los pesos se leen con std::from_chars; al final
+ * se reserva la matriz una sola vez con el número de vértices encontrado.
  */
 class GraphReader {
 public:
     /**
      * Construye un grafo a partir del contenido de un archivo.
+     * El archivo se proyecta en memoria (mmap), sin copiarlo.
      * @param filename Ruta del archivo.
      * @return Objeto Graph construido a partir del contenido.
      */
@@ -24,4 +30,12 @@ public:
      * @return Objeto Graph correspondiente.
      */
     static Graph from_stream(std::istream& input);
+
+    /**
+     * Construye un grafo a partir de un bloque de texto en memoria.
+     * Los registros mal formados se reportan en std::cerr con su línea.
+     * @param data inicio del texto
+     * @param size longitud en bytes
+     */
+    static Graph from_buffer(const char* data, std::size_t size);
 };
@@ -0,0 +1,124 @@
+#pragma once
+#include "graph.hpp"
+#include <vector>
+#include <limits>
+
+/**
+ * Clase IncrementalMST
+ * Mantiene el MST de un subconjunto S de vértices y evalúa intercambios
+ * de un solo vértice (S - u + v) sin reconstruir el árbol completo.
+ *
+ * IDEA:
+ * -----
+ * Sea T = MST(S) y u = S[pos] el vértice a remover.
+ *   - Si u es hoja de T, T - u es exactamente MST(S - u)  (O(k)).
+ *   - Si no, MST(S - u) se recalcula con Prim una sola vez por posición
+ *     (O(k²)) y se reutiliza para todos los candidatos v de esa posición.
+ *
+ * Insertar v en un árbol T' es exacto en O(k) (Chin & Houck): en postorden,
+ * cada subárbol aporta un camino hacia v; de todos los caminos paralelos que
+ * llegan a un vértice se conserva el de menor arista máxima y de los demás
+ * se elimina su arista más pesada.
+ *
+ * Las posiciones son locales: pos indexa el vector de vértices tal como lo
+ * guarda la partícula, de modo que commit_swap(pos, v) equivale a S[pos] = v.
+ *
+ * Con una matriz en precisión simple los pesos se leen como float (Prim
+ * usa los núcleos de 32 bits) y los totales se acumulan en double; el
+ * resultado es el MST de los pesos redondeados a float.
+ */
+class IncrementalMST {
+public:
+    IncrementalMST();
+
+    /**
+     * @param single copia float de graph.adjacency() que reemplaza a la
+     *        matriz double en todas las lecturas, o nullptr
+     */
+    explicit IncrementalMST(const Graph& graph, const DenseMatrix32* single = nullptr);
+
+    /**
+     * Construye el MST del subconjunto desde cero con Prim (O(k²)).
+     * @param vertices IDs internos de los vértices del subconjunto
+     * @return peso total del MST
+     */
+    double build(const std::vector<int>& vertices);
+
+    /**
+     * Evalúa el peso del MST de S - S[pos] + v sin modificar el árbol.
+     * Llamadas consecutivas con la misma pos reutilizan MST(S - S[pos]).
+     * @param pos posición local del vértice a remover
+     * @param v ID interno del vértice a insertar (no debe estar en S)
+     * @return peso total del MST del nuevo subconjunto
+     */
+    double evaluate_swap(int pos, int v);
+
+    /**
+     * Aplica el intercambio S[pos] = v y actualiza el árbol.
+     * @return peso total del nuevo MST
+     */
+    double commit_swap(int pos, int v);
+
+    /** @return peso del MST actual. */
+    double weight() const { return total_; }
+
+    /** @return subconjunto de vértices (IDs internos) en orden local. */
+    const std::vector<int>& vertices() const { return verts_; }
+
+    /**
+     * Posiciones adyacentes a pos en MST(S).
+     * @param out se vacía y recibe las posiciones vecinas
+     */
+    void neighbors(int pos, std::vector<int>& out) const;
+
+    /** @return true si el vértice en pos es hoja (su remoción es O(k)). */
+    bool is_leaf(int pos) const { return deg_[pos] <= 1; }
+
+private:
+    struct Edge {
+        int a, b;       // extremos (posiciones locales)
+        double w;       // peso
+    };
+
+    const Graph* graph_;
+    const DenseMatrix32* single_;  // pesos en precisión simple (opcional)
+    std::vector<int> verts_;       // S en orden local
+    std::vector<Edge> edges_;      // aristas de MST(S)
+    std::vector<int> deg_;         // grado de cada posición en MST(S)
+    double total_;
+
+    // --- Árbol base MST(S - S[base_pos_]) enraizado, en preorden ---
+    int base_pos_;
+    std::vector<Edge> base_edges_;
+    std::vector<int> order_;       // posiciones en preorden
+    std::vector<int> bparent_;     // padre de cada posición en el árbol base
+    std::vector<double> bweight_;  // peso de la arista hacia el padre
+
+    // --- Buffers de trabajo ---
+    std::vector<int> head_, next_, to_;
+    std::vector<double> zw_;       // w(v, S[x])
+    std::vector<double> mw_;       // arista máxima del mejor camino x ~> v
+    std::vector<int> mid_;         // id de esa arista (x: árbol, k + x: hacia v)
+    std::vector<char> deleted_;
+    std::vector<int> rem_, ids_;
+    std::vector<double> key_;
+    std::vector<float> key32_;
+    std::vector<int> par_;
+
+    void prepare_base(int pos);
+    void refresh_degrees();
+    double prim_local(int skip, std::vector<Edge>& out);
+    double insert_vertex(int v);
+
+    // Peso de la arista entre dos IDs globales en la matriz activa
+    double weight(int a, int b) const {
+        return single_ ? (*single_)[a][b] : graph_->adjacency()[a][b];
+    }
+
+    template <typename T>
+    double prim_rows(const BasicDenseMatrix<T>& adj, std::vector<T>& key,
+                     int skip, std::vector<Edge>& out);
+
+    template <typename T>
+    void load_row(const T* row);
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include "pso.hpp"
+#include <string>
+#include <vector>
+
+/**
+ * Clase IslandModel
+ * Modelo de islas: varios enjambres PSO independientes (uno por semilla)
+ * avanzan en paralelo y cada cierto número de iteraciones intercambian
+ * sus mejores conjuntos.
+ *
+ * CICLO:
+ * ------
+ *   1. Cada isla ejecuta `interval` iteraciones (step) en su propio hilo.
+ *   2. Barrera; se copian los gbest de todas las islas a buffers reservados.
+ *   3. Cada isla recibe el gbest de su vecina según la topología, si es
+ *      mejor que el propio, en lugar de su peor partícula (PSO::migrate).
+ *
+ * Una isla que lleva `iterations` iteraciones sin mejorar deja de avanzar
+ * hasta que una migración la mejore; la corrida termina cuando todas están
+ * estancadas o alcanzaron sus límites (PSO::Limits). Como la migración ocurre en barreras y en orden de isla, el
+ * resultado es determinista para un conjunto de semillas dado.
+ */
+class IslandModel {
+public:
+    enum class Topology {
+        Ring,       // la isla i recibe de la isla i - 1
+        AllToAll    // cada isla recibe el mejor gbest de las demás
+    };
+
+    /**
+     * @param graph Grafo completo
+     * @param k Número de vértices a seleccionar
+     * @param swarm_size Partículas por isla
+     * @param iterations Iteraciones sin mejora antes de considerar estancada una isla
+     * @param seeds Una semilla por isla
+     * @param topology Topología de migración
+     * @param interval Iteraciones entre migraciones
+     */
+    IslandModel(const Graph& graph, int k, int swarm_size, int iterations,
+                const std::vector<unsigned>& seeds, Topology topology, int interval);
+
+    /** Comparte una caché de pesos entre todas las islas (ver PSO::set_cache). */
+    void set_cache(SubsetCache* cache);
+
+    /** Restringe la búsqueda de todas las islas (ver PSO::set_candidates). */
+    void set_candidates(const CandidateLists* candidates);
+
+    /** Evalúa todas las islas en precisión simple (ver PSO::set_single_precision). */
+    void set_single_precision(const DenseMatrix32* weights);
+
+    /** Fija los límites de todas las islas (ver PSO::Limits). */
+    void set_limits(const PSO::Limits& limits);
+
+    /** Registra el callback de nuevos gbest en todas las islas. */
+    void set_anytime(const PSO::AnytimeCallback& callback);
+
+    /** Activa la telemetría de todas las islas (ver PSO::set_telemetry). */
+    void set_telemetry(bool enabled);
+
+    /** Configura la búsqueda local de todas las islas (ver PSO::set_sweep). */
+    void set_sweep(PSO::SweepPolicy policy, bool dont_look_bits);
+
+    /**
+     * Inicializa las islas y las ejecuta hasta que todas se estancan.
+     */
+    void run();
+
+    /**
+     * Aplica la búsqueda local sweep() al gbest de cada isla.
+     */
+    void sweep();
+
+    /** @return número de islas. */
+    int size() const { return islands_.size(); }
+
+    /** @return la isla i (su semilla es seeds[i]). */
+    const PSO& island(int i) const { return islands_[i]; }
+
+    /**
+     * Convierte "ring" o "all" en Topology.
+     * @throws std::invalid_argument con cualquier otro valor
+     */
+    static Topology parse_topology(const std::string& name);
+
+private:
+    std::vector<PSO> islands_;
+    Topology topology_;
+    int iterations_;
+    int interval_;
+    std::vector<int> stagnation_;          // iteraciones sin mejora por isla
+    std::vector<std::vector<int>> outbox_; // gbest de cada isla al migrar
+    std::vector<double> outbox_value_;
+
+    void migrate_all();
+    bool finished(int i) const;   // isla estancada o con límites alcanzados
+};
@@ -0,0 +1,320 @@
+#pragma once
+#include <charconv>
+#include <cmath>
+#include <map>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+/**
+ * Clase JsonWriter
+ * Escritor mínimo de JSON en streaming (sin árbol en memoria) para los
+ * reportes de kmst_bench y de la telemetría. Lleva la pila de anidamiento
+ * para colocar las comas; no valida el orden de las llamadas.
+ *
+ *   JsonWriter w(std::cout);
+ *   w.begin_object();
+ *   w.key("n").value(1000);
+ *   w.key("samples").begin_array().value(1.5).value(2.0).end_array();
+ *   w.end_object();
+ */
+class JsonWriter {
+public:
+    /**
+     * @param pretty true: un elemento por línea con sangría; false: todo en
+     *        una línea (JSONL), terminada en '\n' al cerrar el valor raíz
+     */
+    explicit JsonWriter(std::ostream& out, bool pretty = true)
+        : out_(out), pretty_(pretty) {}
+
+    JsonWriter& begin_object() { open('{'); return *this; }
+    JsonWriter& end_object() { close('}'); return *this; }
+    JsonWriter& begin_array() { open('['); return *this; }
+    JsonWriter& end_array() { close(']'); return *this; }
+
+    /** Escribe la clave del siguiente valor dentro de un objeto. */
+    JsonWriter& key(const std::string& k) {
+        separator();
+        quoted(k);
+        out_ << (pretty_ ? ": " : ":");
+        after_key_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(const std::string& s) { separator(); quoted(s); return *this; }
+    JsonWriter& value(const char* s) { return value(std::string(s)); }
+    JsonWriter& value(bool b) { separator(); out_ << (b ? "true" : "false"); return *this; }
+    JsonWriter& value(int x) { separator(); out_ << x; return *this; }
+    JsonWriter& value(long x) { separator(); out_ << x; return *this; }
+    JsonWriter& value(long long x) { separator(); out_ << x; return *this; }
+    JsonWriter& value(unsigned x) { separator(); out_ << x; return *this; }
+    JsonWriter& value(unsigned long x) { separator(); out_ << x; return *this; }
+    JsonWriter& value(unsigned long long x) { separator(); out_ << x; return *this; }
+
+    /**
+     * Representación más corta que conserva el valor exacto. Los no finitos
+     * (sin equivalente en JSON) se escriben como null.
+     */
+    JsonWriter& value(double x) {
+        separator();
+        if (std::isfinite(x)) {
+            char buf[32];
+            auto res = std::to_chars(buf, buf + sizeof buf, x);
+            out_.write(buf, res.ptr - buf);
+        } else {
+            out_ << "null";
+        }
+        return *this;
+    }
+
+    /** Arreglo de números. */
+    template <class T>
+    JsonWriter& value(const std::vector<T>& xs) {
+        begin_array();
+        for (const T& x : xs) value(x);
+        return end_array();
+    }
+
+private:
+    std::ostream& out_;
+    bool pretty_;
+    std::vector<bool> first_;   // por nivel: aún no se escribe ningún elemento
+    bool after_key_ = false;
+
+    void separator() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        if (!first_.empty()) {
+            if (!first_.back()) out_ << ',';
+            first_.back() = false;
+            if (pretty_) out_ << '\n' << std::string(2 * first_.size(), ' ');
+        }
+    }
+
+    void open(char c) {
+        separator();
+        out_ << c;
+        first_.push_back(true);
+    }
+
+    void close(char c) {
+        bool empty = first_.back();
+        first_.pop_back();
+        if (!empty && pretty_) out_ << '\n' << std::string(2 * first_.size(), ' ');
+        out_ << c;
+        if (first_.empty()) out_ << '\n';
+    }
+
+    void quoted(const std::string& s) {
+        out_ << '"';
+        for (char c : s) {
+            switch (c) {
+                case '"':  out_ << "\\\""; break;
+                case '\\': out_ << "\\\\"; break;
+                case '\n': out_ << "\\n"; break;
+                case '\t': out_ << "\\t"; break;
+                case '\r': out_ << "\\r"; break;
+                default:
+                    if (static_cast<unsigned char>(c) < 0x20) {
+                        const char* hex = "0123456789abcdef";
+                        out_ << "\\u00" << hex[(c >> 4) & 0xf] << hex[c & 0xf];
+                    } else {
+                        out_ << c;
+                    }
+            }
+        }
+        out_ << '"';
+    }
+};
+
+/**
+ * Clase JsonValue
+ * Valor JSON en memoria y lector recursivo mínimo, para las solicitudes
+ * del modo servidor (objetos pequeños). Los números se guardan como double;
+ * \uXXXX se decodifica a UTF-8 sin pares sustitutos.
+ */
+class JsonValue {
+public:
+    enum class Type { Null, Bool, Number, String, Array, Object };
+
+    JsonValue() = default;
+
+    /**
+     * Lee un documento completo.
+     * @throws std::runtime_error con la posición del primer error
+     */
+    static JsonValue parse(const std::string& text) {
+        size_t pos = 0;
+        JsonValue v = parse_value(text, pos, 0);
+        skip_space(text, pos);
+        if (pos != text.size())
+            fail("contenido después del valor", pos);
+        return v;
+    }
+
+    Type type() const { return type_; }
+    bool is_null() const { return type_ == Type::Null; }
+    bool is_bool() const { return type_ == Type::Bool; }
+    bool is_number() const { return type_ == Type::Number; }
+    bool is_string() const { return type_ == Type::String; }
+    bool is_array() const { return type_ == Type::Array; }
+    bool is_object() const { return type_ == Type::Object; }
+
+    bool as_bool() const { expect(Type::Bool, "booleano"); return bool_; }
+    double as_number() const { expect(Type::Number, "número"); return number_; }
+    const std::string& as_string() const { expect(Type::String, "cadena"); return string_; }
+    const std::vector<JsonValue>& as_array() const { expect(Type::Array, "arreglo"); return array_; }
+
+    /** @return miembro del objeto, o nullptr si no existe (o no es objeto). */
+    const JsonValue* find(const std::string& key) const {
+        if (type_ != Type::Object) return nullptr;
+        auto it = object_.find(key);
+        return it == object_.end() ? nullptr : &it->second;
+    }
+
+private:
+    Type type_ = Type::Null;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> array_;
+    std::map<std::string, JsonValue> object_;
+
+    static constexpr int MAX_DEPTH = 64;
+
+    void expect(Type t, const char* name) const {
+        if (type_ != t)
+            throw std::runtime_error(std::string("JSON: se esperaba ") + name);
+    }
+
+    [[noreturn]] static void fail(const char* what, size_t pos) {
+        throw std::runtime_error(std::string("JSON: ") + what + " en la posición " +
+                                 std::to_string(pos));
+    }
+
+    static void skip_space(const std::string& s, size_t& pos) {
+        while (pos < s.size() && (s[pos] == ' ' || s[pos] == '\t' || s[pos] == '\n' || s[pos] == '\r'))
+            ++pos;
+    }
+
+    static void literal(const std::string& s, size_t& pos, const char* word) {
+        for (const char* c = word; *c; ++c, ++pos)
+            if (pos >= s.size() || s[pos] != *c)
+                fail("literal inválido", pos);
+    }
+
+    static JsonValue parse_value(const std::string& s, size_t& pos, int depth) {
+        if (depth > MAX_DEPTH)
+            fail("anidamiento excesivo", pos);
+        skip_space(s, pos);
+        if (pos >= s.size())
+            fail("fin inesperado", pos);
+
+        JsonValue v;
+        const char c = s[pos];
+        if (c == '{') {
+            v.type_ = Type::Object;
+            ++pos;
+            skip_space(s, pos);
+            if (pos < s.size() && s[pos] == '}') { ++pos; return v; }
+            for (;;) {
+                skip_space(s, pos);
+                if (pos >= s.size() || s[pos] != '"')
+                    fail("se esperaba una clave", pos);
+                std::string key = parse_string(s, pos);
+                skip_space(s, pos);
+                if (pos >= s.size() || s[pos] != ':')
+                    fail("se esperaba ':'", pos);
+                ++pos;
+                v.object_[key] = parse_value(s, pos, depth + 1);
+                skip_space(s, pos);
+                if (pos < s.size() && s[pos] == ',') { ++pos; continue; }
+                if (pos < s.size() && s[pos] == '}') { ++pos; return v; }
+                fail("se esperaba ',' o '}'", pos);
+            }
+        }
+        if (c == '[') {
+            v.type_ = Type::Array;
+            ++pos;
+            skip_space(s, pos);
+            if (pos < s.size() && s[pos] == ']') { ++pos; return v; }
+            for (;;) {
+                v.array_.push_back(parse_value(s, pos, depth + 1));
+                skip_space(s, pos);
+                if (pos < s.size() && s[pos] == ',') { ++pos; continue; }
+                if (pos < s.size() && s[pos] == ']') { ++pos; return v; }
+                fail("se esperaba ',' o ']'", pos);
+            }
+        }
+        if (c == '"') {
+            v.type_ = Type::String;
+            v.string_ = parse_string(s, pos);
+            return v;
+        }
+        if (c == 't') { literal(s, pos, "true"); v.type_ = Type::Bool; v.bool_ = true; return v; }
+        if (c == 'f') { literal(s, pos, "false"); v.type_ = Type::Bool; return v; }
+        if (c == 'n') { literal(s, pos, "null"); return v; }
+
+        // Número: from_chars no acepta '+' inicial, igual que JSON, pero sí
+        // inf, infinity y nan (con o sin '-'), que JSON no tiene
+        const bool digit = c >= '0' && c <= '9';
+        const bool minus = c == '-' && pos + 1 < s.size() && s[pos + 1] >= '0' && s[pos + 1] <= '9';
+        if (!digit && !minus)
+            fail("valor inválido", pos);
+        v.type_ = Type::Number;
+        auto res = std::from_chars(s.data() + pos, s.data() + s.size(), v.number_);
+        if (res.ec != std::errc())
+            fail("valor inválido", pos);
+        pos = res.ptr - s.data();
+        return v;
+    }
+
+    static std::string parse_string(const std::string& s, size_t& pos) {
+        std::string out;
+        ++pos;   // comilla inicial
+        while (pos < s.size() && s[pos] != '"') {
+            char c = s[pos++];
+            if (c != '\\') {
+                out += c;
+                continue;
+            }
+            if (pos >= s.size())
+                break;
+            char e = s[pos++];
+            switch (e) {
+                case '"': case '\\': case '/': out += e; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u': {
+                    unsigned cp = 0;
+                    if (pos + 4 > s.size() ||
+                        std::from_chars(s.data() + pos, s.data() + pos + 4, cp, 16).ptr != s.data() + pos + 4)
+                        fail("escape \\u inválido", pos);
+                    pos += 4;
+                    if (cp < 0x80) {
+                        out += static_cast<char>(cp);
+                    } else if (cp < 0x800) {
+                        out += static_cast<char>(0xC0 | (cp >> 6));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    } else {
+                        out += static_cast<char>(0xE0 | (cp >> 12));
+                        out += static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+                        out += static_cast<char>(0x80 | (cp & 0x3F));
+                    }
+                    break;
+                }
+                default: fail("escape inválido", pos - 1);
+            }
+        }
+        if (pos >= s.size())
+            fail("cadena sin cerrar", pos);
+        ++pos;   // comilla final
+        return out;
+    }
+};
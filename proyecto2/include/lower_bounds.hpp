@@ -0,0 +1,51 @@
+#pragma once
+#include "graph.hpp"
+
+/**
+ * Clase LowerBounds
+ * Cotas inferiores del k-MST sobre la matriz completada: ningún árbol de
+ * k vértices pesa menos que value(), así que (f(gbest) - value()) / f(gbest)
+ * acota la distancia de gbest al óptimo.
+ *
+ * COTAS:
+ * ------
+ *   smallest_edges  suma de las k - 1 aristas más ligeras del grafo.
+ *   forest          bosque mínimo de k - 1 aristas: las k - 1 aristas más
+ *                   ligeras del MST de todo el grafo (Kruskal es óptimo en
+ *                   el matroide gráfico y un k-árbol es un bosque de k - 1
+ *                   aristas). Siempre >= smallest_edges.
+ *   incident        enraizando el árbol, cada vértice salvo la raíz paga la
+ *                   arista hacia su padre, que pesa al menos su arista
+ *                   incidente más ligera d1(v): suma de los k - 1 menores d1.
+ *
+ * forest e incident no se dominan entre sí; value() es la mayor. Todas
+ * cuestan O(n²): las filas se recorren en paralelo y Prim sobre el grafo
+ * completo es secuencial.
+ */
+class LowerBounds {
+public:
+    /**
+     * @param graph grafo ya completado para k
+     * @param k tamaño del árbol
+     */
+    LowerBounds(const Graph& graph, int k);
+
+    double smallest_edges() const { return smallest_edges_; }
+    double forest() const { return forest_; }
+    double incident() const { return incident_; }
+
+    /** @return la mejor (mayor) de las cotas. */
+    double value() const;
+
+    /**
+     * Brecha relativa de un valor respecto a la cota.
+     * @return (value - bound) / value, o NaN si value <= 0 o value < bound
+     *         (más allá del redondeo): nunca se reporta como óptimo
+     */
+    static double gap(double value, double bound);
+
+private:
+    double smallest_edges_ = 0.0;
+    double forest_ = 0.0;
+    double incident_ = 0.0;
+};
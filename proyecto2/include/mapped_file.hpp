@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <cstddef>
+
+/**
+ * Clase MappedFile
+ * Proyecta un archivo completo en memoria (solo lectura) con mmap.
+ * El mapeo se libera al destruir el objeto.
+ */
+class MappedFile {
+public:
+    /**
+     * Abre y proyecta el archivo.
+     * @param filename Ruta del archivo.
+     * @throws std::runtime_error si no se puede abrir o proyectar.
+     */
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+};
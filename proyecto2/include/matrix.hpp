@@ -0,0 +1,127 @@
+#pragma once
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#include <algorithm>
+
+/**
+ * Allocator con alineación fija (por defecto, una línea de caché).
+ */
+template <typename T, std::size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template <typename U>
+    struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() noexcept = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(std::size_t count) {
+        std::size_t bytes = (count * sizeof(T) + Align - 1) / Align * Align;
+        void* p = std::aligned_alloc(Align, bytes);
+        if (!p) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T* p, std::size_t) noexcept { std::free(p); }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+};
+
+/**
+ * Clase DenseMatrix
+ * Matriz cuadrada n×n en un solo bloque contiguo, row-major y alineado a
+ * línea de caché. Cada fila se rellena hasta un múltiplo de una línea
+ * (8 doubles o 16 floats: stride), de modo que todas las filas inician
+ * alineadas a 64 bytes.
+ *
+ * m[i] regresa un puntero al inicio de la fila i, así m[i][j] se usa igual
+ * que con std::vector<std::vector<double>> pero sin indirección por fila.
+ *
+ * DenseMatrix guarda doubles; DenseMatrix32 (floats) es la copia en
+ * precisión simple que usa la búsqueda con PSO::set_single_precision().
+ */
+template <typename T>
+class BasicDenseMatrix {
+public:
+    using value_type = T;
+
+    static constexpr std::size_t ALIGN = 64;
+    static constexpr std::size_t PAD = ALIGN / sizeof(T);
+
+    BasicDenseMatrix() : n_(0), stride_(0) {}
+
+    BasicDenseMatrix(int n, T fill) : n_(n), stride_(round_up(n)) {
+        data_.assign(stride_ * n_, fill);
+    }
+
+    /**
+     * Copia convirtiendo cada entrada a T (p. ej. double → float, con
+     * redondeo al más cercano; +inf se conserva).
+     */
+    template <typename U>
+    explicit BasicDenseMatrix(const BasicDenseMatrix<U>& other)
+        : BasicDenseMatrix(other.size(), T()) {
+        for (int i = 0; i < n_; ++i) {
+            const U* src = other[i];
+            T* dst = (*this)[i];
+            for (int j = 0; j < n_; ++j)
+                dst[j] = static_cast<T>(src[j]);
+        }
+    }
+
+    /** @return número de filas (y columnas) en uso. */
+    int size() const { return n_; }
+
+    /** @return distancia en elementos entre filas consecutivas. */
+    std::size_t stride() const { return stride_; }
+
+    T* operator[](int i) { return data_.data() + i * stride_; }
+    const T* operator[](int i) const { return data_.data() + i * stride_; }
+
+    T* data() { return data_.data(); }
+    const T* data() const { return data_.data(); }
+
+    /**
+     * Cambia el tamaño a n×n conservando el contenido; las entradas nuevas
+     * se inicializan con fill. La capacidad crece de forma geométrica, así
+     * agregar vértices uno a uno cuesta O(n²) amortizado en total.
+     */
+    void resize(int n, T fill) {
+        if (n <= n_) {
+            n_ = n;
+            return;
+        }
+
+        std::size_t rows_cap = stride_ ? data_.size() / stride_ : 0;
+        if ((std::size_t)n > stride_ || (std::size_t)n > rows_cap) {
+            std::size_t cap = round_up(std::max<std::size_t>(n, 2 * (std::size_t)n_));
+            std::vector<T, AlignedAllocator<T, ALIGN>> grown(cap * cap, fill);
+            for (int i = 0; i < n_; ++i)
+                std::copy(data_.data() + i * stride_, data_.data() + i * stride_ + n_,
+                          grown.data() + i * cap);
+            data_.swap(grown);
+            stride_ = cap;
+        } else {
+            for (int i = 0; i < n_; ++i)
+                std::fill(data_.data() + i * stride_ + n_, data_.data() + i * stride_ + n, fill);
+            for (int i = n_; i < n; ++i)
+                std::fill(data_.data() + i * stride_, data_.data() + i * stride_ + n, fill);
+        }
+        n_ = n;
+    }
+
+private:
+    int n_;
+    std::size_t stride_;
+    std::vector<T, AlignedAllocator<T, ALIGN>> data_;
+
+    static std::size_t round_up(std::size_t n) { return (n + PAD - 1) / PAD * PAD; }
+};
+
+using DenseMatrix = BasicDenseMatrix<double>;
+using DenseMatrix32 = BasicDenseMatrix<float>;
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+/**
+ * Clase MpmcQueue
+ * Cola acotada sin candados para varios productores y varios consumidores
+ * (anillo de Vyukov).
+ *
+ * Cada celda lleva un número de secuencia: un productor puede escribir en la
+ * celda de la posición p cuando su secuencia vale p, y al terminar la deja
+ * en p + 1 para el consumidor; este la libera dejando p + capacidad. Las
+ * posiciones se reservan con compare_exchange, así que no hay candados y
+ * un hilo lento solo retrasa su propia celda.
+ */
+template <class T>
+class MpmcQueue {
+public:
+    /** @param capacity capacidad mínima (se redondea a potencia de 2) */
+    explicit MpmcQueue(std::size_t capacity)
+        : mask_(std::bit_ceil(capacity < 2 ? std::size_t(2) : capacity) - 1),
+          cells_(std::make_unique<Cell[]>(mask_ + 1)),
+          head_(0), tail_(0)
+    {
+        for (std::size_t i = 0; i <= mask_; ++i)
+            cells_[i].seq.store(i, std::memory_order_relaxed);
+    }
+
+    MpmcQueue(const MpmcQueue&) = delete;
+    MpmcQueue& operator=(const MpmcQueue&) = delete;
+
+    /**
+     * Encola moviendo value.
+     * @return false si la cola está llena (value no se modifica)
+     */
+    bool try_push(T& value) {
+        std::size_t pos = head_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+
+            if (diff == 0) {
+                if (head_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.data = std::move(value);
+                    cell.seq.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = head_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * Desencola en out.
+     * @return false si la cola está vacía
+     */
+    bool try_pop(T& out) {
+        std::size_t pos = tail_.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell& cell = cells_[pos & mask_];
+            std::size_t seq = cell.seq.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+
+            if (diff == 0) {
+                if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    out = std::move(cell.data);
+                    cell.seq.store(pos + mask_ + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = tail_.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    struct alignas(64) Cell {
+        std::atomic<std::size_t> seq;
+        T data;
+    };
+
+    std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+    alignas(64) std::atomic<std::size_t> head_;   // siguiente posición a escribir
+    alignas(64) std::atomic<std::size_t> tail_;   // siguiente posición a leer
+};
@@ -0,0 +1,160 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Clase Philox
+ * Generador basado en contador Philox4x32-10 (Salmon et al., SC'11).
+ *
+ * Cada bloque de 4 enteros de 32 bits es una función pura de
+ * (clave, contador): no hay estado que avanzar, así que cualquier número
+ * de la secuencia se obtiene directamente y el resultado no depende de
+ * qué hilo lo pida ni en qué orden.
+ *
+ * CONVENCIÓN:
+ * -----------
+ *   clave    = (seed, stream)          stream = índice de partícula
+ *   contador = (bloque_lo, bloque_hi, paso_lo, paso_hi)
+ *
+ * seek(paso) coloca el generador al inicio del paso; las extracciones
+ * siguientes recorren los bloques 0, 1, 2, ... de ese paso. Así, el número
+ * d del paso t de la partícula i con semilla s es siempre el mismo.
+ *
+ * below() y uniform01() no usan las distribuciones de <random>, cuyo
+ * algoritmo depende de la biblioteca estándar; el flujo es idéntico en
+ * cualquier plataforma.
+ */
+class Philox {
+public:
+    using result_type = std::uint32_t;
+
+    Philox() : Philox(0, 0) {}
+
+    Philox(std::uint32_t seed, std::uint32_t stream)
+        : key_{seed, stream}, step_(0), block_(0), used_(4) {}
+
+    static constexpr result_type min() { return 0; }
+    static constexpr result_type max() { return 0xFFFFFFFFu; }
+
+    /** Coloca el generador al inicio del paso dado. */
+    void seek(std::uint64_t step) {
+        step_ = step;
+        block_ = 0;
+        used_ = 4;
+    }
+
+    /** @return siguiente entero de 32 bits del paso actual. */
+    result_type operator()() {
+        if (used_ == 4) {
+            buffer_ = philox4x32(key_, counter(block_++));
+            used_ = 0;
+        }
+        return buffer_[used_++];
+    }
+
+    /**
+     * Entero uniforme en [0, n) sin sesgo (multiplicación de Lemire con
+     * rechazo). n debe ser positivo.
+     */
+    std::uint32_t below(std::uint32_t n) {
+        std::uint64_t m = std::uint64_t((*this)()) * n;
+        std::uint32_t low = static_cast<std::uint32_t>(m);
+        if (low < n) {
+            const std::uint32_t threshold = (0u - n) % n;
+            while (low < threshold) {
+                m = std::uint64_t((*this)()) * n;
+                low = static_cast<std::uint32_t>(m);
+            }
+        }
+        return static_cast<std::uint32_t>(m >> 32);
+    }
+
+    /** @return real uniforme en [0, 1) con 53 bits. */
+    double uniform01() {
+        const std::uint32_t a = (*this)() >> 5;
+        const std::uint32_t b = (*this)() >> 6;
+        return (a * 67108864.0 + b) * (1.0 / 9007199254740992.0);
+    }
+
+    /**
+     * Escribe los siguientes `count` enteros del paso actual, los mismos que
+     * darían `count` llamadas a operator(). Los bloques completos se
+     * calculan de 8 en 8 en forma SoA (vectorizable).
+     */
+    void generate(std::uint32_t* out, std::size_t count) {
+        while (count > 0 && used_ < 4) {
+            *out++ = buffer_[used_++];
+            --count;
+        }
+
+        constexpr int L = 8;
+        while (count >= 4 * L) {
+            std::uint32_t c0[L], c1[L], c2[L], c3[L];
+            for (int l = 0; l < L; ++l) {
+                c0[l] = static_cast<std::uint32_t>(block_ + l);
+                c1[l] = static_cast<std::uint32_t>((block_ + l) >> 32);
+                c2[l] = static_cast<std::uint32_t>(step_);
+                c3[l] = static_cast<std::uint32_t>(step_ >> 32);
+            }
+            std::uint32_t k0 = key_[0], k1 = key_[1];
+            for (int r = 0; r < 10; ++r) {
+                for (int l = 0; l < L; ++l) {
+                    const std::uint64_t p0 = std::uint64_t(M0) * c0[l];
+                    const std::uint64_t p1 = std::uint64_t(M1) * c2[l];
+                    const std::uint32_t n0 = static_cast<std::uint32_t>(p1 >> 32) ^ c1[l] ^ k0;
+                    const std::uint32_t n2 = static_cast<std::uint32_t>(p0 >> 32) ^ c3[l] ^ k1;
+                    c1[l] = static_cast<std::uint32_t>(p1);
+                    c3[l] = static_cast<std::uint32_t>(p0);
+                    c0[l] = n0;
+                    c2[l] = n2;
+                }
+                k0 += W0;
+                k1 += W1;
+            }
+            for (int l = 0; l < L; ++l) {
+                out[4 * l + 0] = c0[l];
+                out[4 * l + 1] = c1[l];
+                out[4 * l + 2] = c2[l];
+                out[4 * l + 3] = c3[l];
+            }
+            block_ += L;
+            out += 4 * L;
+            count -= 4 * L;
+        }
+
+        while (count-- > 0)
+            *out++ = (*this)();
+    }
+
+    /** Philox4x32-10 de un bloque. */
+    static std::array<std::uint32_t, 4> philox4x32(std::array<std::uint32_t, 2> key,
+                                                   std::array<std::uint32_t, 4> ctr) {
+        for (int r = 0; r < 10; ++r) {
+            const std::uint64_t p0 = std::uint64_t(M0) * ctr[0];
+            const std::uint64_t p1 = std::uint64_t(M1) * ctr[2];
+            ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+                   static_cast<std::uint32_t>(p1),
+                   static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+                   static_cast<std::uint32_t>(p0)};
+            key[0] += W0;
+            key[1] += W1;
+        }
+        return ctr;
+    }
+
+private:
+    static constexpr std::uint32_t M0 = 0xD2511F53u, M1 = 0xCD9E8D57u;
+    static constexpr std::uint32_t W0 = 0x9E3779B9u, W1 = 0xBB67AE85u;
+
+    std::array<std::uint32_t, 2> key_;
+    std::uint64_t step_;
+    std::uint64_t block_;                 // siguiente bloque del paso
+    std::array<std::uint32_t, 4> buffer_{};
+    int used_;                            // enteros ya entregados de buffer_
+
+    std::array<std::uint32_t, 4> counter(std::uint64_t block) const {
+        return {static_cast<std::uint32_t>(block), static_cast<std::uint32_t>(block >> 32),
+                static_cast<std::uint32_t>(step_), static_cast<std::uint32_t>(step_ >> 32)};
+    }
+};
@@ -0,0 +1,58 @@
+#pragma once
+#include <string>
+
+/**
+ * Núcleos del algoritmo de Prim denso sobre subconjuntos de vértices.
+ *
+ * Los vértices que aún no están en el árbol se mantienen compactados al
+ * frente de los arreglos (ids, key): al agregar uno al árbol se intercambia
+ * con el último. Así el ciclo interno no tiene rama "in_mst" y el compilador
+ * puede vectorizar la relajación y la búsqueda del mínimo.
+ *
+ * Hay tres implementaciones (escalar, AVX2 y AVX-512) y se elige en tiempo de
+ * ejecución según el CPU. Las vectoriales hacen una sola pasada: reúnen la
+ * fila con gather, actualizan key con máscaras y llevan el argmin por carril.
+ * Todas devuelven el mismo índice (el primer mínimo).
+ *
+ * Cada núcleo existe en double y en float (precisión simple: el doble de
+ * carriles por vector y la mitad de bytes por gather).
+ */
+namespace prim_kernel {
+
+/**
+ * Relaja key[t] = min(key[t], row[ids[t]]) para t < r y regresa el índice
+ * del menor key (el primero en caso de empate).
+ *
+ * @param row fila de la matriz de adyacencia del vértice recién agregado
+ * @param ids IDs globales de los vértices pendientes
+ * @param key costo mínimo actual de conectar cada pendiente al árbol
+ * @param r número de vértices pendientes (r > 0)
+ */
+int relax_argmin(const double* row, const int* ids, double* key, int r);
+
+/**
+ * Igual que relax_argmin, registrando par[t] = u cuando la arista mejora.
+ */
+int relax_argmin_parent(const double* row, const int* ids, double* key,
+                        int* par, int u, int r);
+
+/** Versión en precisión simple de relax_argmin. */
+int relax_argmin(const float* row, const int* ids, float* key, int r);
+
+/** Versión en precisión simple de relax_argmin_parent. */
+int relax_argmin_parent(const float* row, const int* ids, float* key,
+                        int* par, int u, int r);
+
+/** @return implementación elegida: "avx512", "avx2" o "scalar". */
+const char* isa();
+
+/**
+ * Fuerza una implementación ("avx512", "avx2", "scalar") o vuelve a la
+ * elección automática ("auto"). Pensado para pruebas y benchmarks: no debe
+ * llamarse mientras otro hilo usa los núcleos.
+ *
+ * @return false si el nombre no existe o el CPU no la soporta (no cambia nada)
+ */
+bool set_isa(const std::string& name);
+
+}
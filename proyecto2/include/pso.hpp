@@ -1,10 +1,20 @@
 #pragma once
 #include "graph.hpp"
+#include "incremental_mst.hpp"
+#include "subset_cache.hpp"
+#include "dynamic_bitset.hpp"
+#include "candidate_lists.hpp"
+#include "telemetry.hpp"
+#include "philox.hpp"
 #include <vector>
+#include <atomic>
 #include <random>
 #include <limits>
 #include <unordered_set>
 #include <iomanip>
+#include <string>
+#include <chrono>
+#include <functional>
 
 /**
  * PSO Discreto (D-PSO) para el problema del k-MST.
@@ -49,11 +59,20 @@ public:
         std::vector<int> best;           // Mejor solución personal pbest
         double best_value;               // f(pbest) = peso del MST
         double current_value;            // f(S) = peso del MST actual
+        IncrementalMST tree;             // MST(S) para evaluar intercambios
+        Philox rng;                      // clave (seed, índice); un paso por movimiento
+        std::uint64_t step;              // movimientos hechos (paso 0 = inicialización)
+        std::uint64_t hash;              // hash Zobrist de current (con caché)
+        bool stale;                      // tree no corresponde a current
+        DynamicBitset members;           // pertenencia a current (n bits)
+        std::vector<int> candidates;     // buffer de transition(), capacidad fija
+        telemetry::Counters stats;       // contadores propios (sin atomics)
 
         Particle()
             : current(), best(), 
               best_value(std::numeric_limits<double>::infinity()),
-              current_value(std::numeric_limits<double>::infinity()) {}
+              current_value(std::numeric_limits<double>::infinity()),
+              step(0), hash(0), stale(false) {}
     };
 
     /**
@@ -69,6 +88,47 @@ public:
               gbest_value(std::numeric_limits<double>::infinity()) {}
     };
 
+    /**
+     * Movimiento discreto: S[pos] = vertex.
+     * pos = -1 indica que no hubo candidato y S no cambia.
+     */
+    struct Move {
+        int pos;
+        int vertex;
+        int branch = -1;     // telemetry::Branch de transition()
+    };
+
+    /**
+     * Límites de una corrida. run() y sweep() se detienen en cuanto se
+     * cumple cualquiera; gbest conserva siempre el mejor conjunto encontrado.
+     * El límite de estancamiento es el parámetro iterations del constructor.
+     */
+    struct Limits {
+        double seconds = 0.0;          // tiempo de pared desde initialize() (0 = sin límite)
+        long long evaluations = 0;     // evaluaciones del MST (0 = sin límite)
+        double target = -std::numeric_limits<double>::infinity();  // f(gbest) <= target
+
+        // Bandera compartida entre corridas (nullptr = ninguna): quien alcanza
+        // target la activa y las demás se detienen al verla
+        std::atomic<bool>* stop = nullptr;
+    };
+
+    /**
+     * Se llama con cada nuevo gbest: semilla, segundos desde initialize(),
+     * peso y conjunto. Puede llamarse desde varios hilos a la vez (un PSO
+     * por hilo), así que debe sincronizar su salida.
+     */
+    using AnytimeCallback = std::function<void(unsigned seed, double seconds, double value,
+                                               const std::vector<int>& set)>;
+
+    /**
+     * Política de la búsqueda local sweep().
+     */
+    enum class SweepPolicy {
+        First,   // aplica el primer intercambio mejorante (orden (i, j))
+        Best     // aplica el mejor intercambio de todo el vecindario
+    };
+
 private:
     // --- Problema ---
     const Graph& graph_;     // Grafica completa
@@ -84,10 +144,31 @@ private:
 
     // --- Estado ---
     Swarm swarm_;
+    unsigned seed_;          // Semilla de la corrida
+    int threads_;            // 0 = secuencial; > 0 = partículas en paralelo
+    SubsetCache* cache_;     // memoria de pesos compartida (opcional)
+    SweepPolicy sweep_policy_;
+    bool dlb_;               // don't-look bits en sweep()
+    const CandidateLists* candidates_;  // vecinos cercanos (opcional)
+    const DenseMatrix32* single_;       // pesos en precisión simple (opcional)
+
+    // --- Límites y reporte ---
+    Limits limits_;
+    AnytimeCallback anytime_;
+    std::chrono::steady_clock::time_point start_;
+    long long evaluations_;  // una por partícula e iteración, una por intercambio probado
+
+    // --- Telemetría ---
+    bool telemetry_;
+    std::uint64_t gbest_improvements_;
+    std::uint64_t sweep_moves_;
+    telemetry::Counters sweep_counters_;   // consultas a la caché desde sweep()
+    double search_seconds_;
+    double sweep_seconds_;
 
     // --- Aleatoriedad ---
-    mutable std::mt19937 rng_;
-    mutable std::uniform_real_distribution<double> dist01_;
+    mutable Philox rng_;     // flujo del enjambre: clave (seed, SWARM_STREAM)
+    static constexpr std::uint32_t SWARM_STREAM = 0xFFFFFFFFu;
 
 public:
     /**
@@ -115,6 +196,52 @@ public:
      */
     void run();
 
+    /**
+     * Mueve las partículas de cada iteración de run() en paralelo.
+     *
+     * En cada iteración todas las partículas se mueven contra el gbest de la
+     * iteración anterior y gbest se actualiza al final, en orden de índice.
+     * Con threads = 0 (por defecto) se mueven una tras otra; con threads > 0,
+     * en paralelo. Como cada partícula usa su propio flujo aleatorio, el
+     * resultado es el mismo para una semilla dada con cualquier número de
+     * hilos, incluido 0 (salvo con set_cache, ver ahí).
+     *
+     * @param threads número de hilos de OpenMP (0 = secuencial)
+     */
+    void set_threads(int threads) { threads_ = threads; }
+
+    /**
+     * Consulta una memoria de pesos de MST antes de evaluar cada conjunto.
+     *
+     * Con un acierto la partícula toma el peso guardado sin tocar su árbol,
+     * que queda marcado como desactualizado y se reconstruye en el siguiente
+     * fallo. La caché puede compartirse entre enjambres del mismo grafo y k.
+     *
+     * Un peso guardado puede diferir en el último bit del que daría el árbol
+     * (otro orden de suma), y que un conjunto esté guardado depende del orden
+     * en que los hilos lo evaluaron: con caché la corrida deja de ser
+     * reproducible bit a bit.
+     *
+     * @param cache caché compartida, o nullptr para desactivarla
+     */
+    void set_cache(SubsetCache* cache) { cache_ = cache; }
+
+    /**
+     * Ejecuta una sola iteración sobre todo el enjambre.
+     * @return true si gbest mejoró en esta iteración
+     */
+    bool step();
+
+    /**
+     * Recibe un conjunto de otro enjambre (modelo de islas): reemplaza la
+     * posición actual de la partícula con peor valor y actualiza su pbest
+     * y gbest si corresponde. No reserva memoria.
+     *
+     * @param set conjunto de k vértices
+     * @return true si gbest mejoró
+     */
+    bool migrate(const std::vector<int>& set);
+
     /**
      * Obtiene el mejor conjunto de vértices encontrado.
      * @return Vector de IDs de vértices de la mejor solución
@@ -127,10 +254,96 @@ public:
      */
     double best_value() const { return swarm_.gbest_value; }
 
+    /** Fija los límites de tiempo, evaluaciones y objetivo (ver Limits). */
+    void set_limits(const Limits& limits) { limits_ = limits; }
+
+    /** Registra el callback de reporte de cada nuevo gbest (ver AnytimeCallback). */
+    void set_anytime(AnytimeCallback callback) { anytime_ = std::move(callback); }
+
+    /** @return true si se alcanzó alguno de los límites. */
+    bool expired() const;
+
+    /**
+     * @return true si value alcanza target (cota de --target o de --gap); en
+     * ese caso activa también la bandera stop compartida.
+     */
+    bool reached(double value) const;
+
+    /** @return segundos desde initialize(). */
+    double elapsed() const;
+
+    /** @return evaluaciones realizadas desde initialize(). */
+    long long evaluations() const { return evaluations_; }
+
+    /**
+     * Activa los contadores por rama de transición (ver telemetry::Counters).
+     * Los tiempos, evaluaciones y mejoras de gbest se registran siempre.
+     */
+    void set_telemetry(bool enabled) { telemetry_ = enabled; }
+
+    /** @return estadísticas acumuladas de la corrida (suma de las partículas). */
+    telemetry::SearchStats stats() const;
+
+    /**
+     * Restringe la búsqueda a vértices cercanos al conjunto actual.
+     *
+     * La rama de exploración de transition() propone un vecino cercano de un
+     * miembro al azar en lugar de cualquier vértice, y sweep() solo prueba
+     * los vértices de la unión de las listas de los miembros.
+     *
+     * @param candidates listas de vecinos (deben vivir más que el PSO), o
+     *        nullptr para buscar sobre todos los vértices
+     */
+    void set_candidates(const CandidateLists* candidates) {
+        candidates_ = (candidates && candidates->size() > 0) ? candidates : nullptr;
+    }
+
+    /**
+     * Evalúa todos los MST de la búsqueda (run, sweep, migraciones) con una
+     * copia float de la matriz completada: la mitad de bytes por gather y el
+     * doble de carriles en los núcleos de Prim. Los pesos de f() quedan
+     * redondeados a float (los totales se suman en double), así que
+     * best_value() es aproximado; el llamador debe recalcular el peso de
+     * best_set() en double (Graph::prim_subset_full). Una SubsetCache no
+     * debe compartirse entre corridas de distinta precisión.
+     *
+     * @param weights DenseMatrix32(graph.adjacency()) (debe vivir más que
+     *        el PSO), o nullptr para evaluar en double
+     */
+    void set_single_precision(const DenseMatrix32* weights) { single_ = weights; }
+
+    /**
+     * Configura la búsqueda local sweep().
+     *
+     * Con don't-look bits, una posición cuyo vecindario no tuvo mejoras se
+     * salta en las pasadas siguientes hasta que ella o una de sus vecinas en
+     * el MST cambia. Es más rápido pero el resultado puede no ser un mínimo
+     * local estricto del vecindario 1-swap.
+     *
+     * @param policy primer intercambio mejorante o mejor intercambio
+     * @param dont_look_bits activa los don't-look bits
+     */
+    void set_sweep(SweepPolicy policy, bool dont_look_bits) {
+        sweep_policy_ = policy;
+        dlb_ = dont_look_bits;
+    }
+
+    /**
+     * Convierte "first" o "best" en SweepPolicy.
+     * @throws std::invalid_argument con cualquier otro valor
+     */
+    static SweepPolicy parse_sweep_policy(const std::string& name);
+
     /**
      * Realiza una pasada de barrido (sweep) para mejorar la solución actual.
      * Intenta intercambiar vértices dentro y fuera del conjunto actual
-     * para reducir el peso del MST.
+     * para reducir el peso del MST. Cada intercambio se evalúa de forma
+     * incremental con IncrementalMST (O(k) por candidato).
+     *
+     * Las posiciones se reparten entre los hilos de set_threads(), cada uno
+     * con su propio árbol. Con SweepPolicy::First el intercambio aplicado es
+     * el mismo que encontraría el recorrido secuencial, para cualquier
+     * número de hilos.
      */
     void sweep() ;
 
@@ -146,10 +359,47 @@ private:
      * Realiza la transición discreta de una partícula.
      * Calcula los conjuntos A, B, C y selecciona un vértice para intercambio.
      * 
+     * Usa el flujo aleatorio y los buffers de la partícula (no reserva
+     * memoria); el resto del estado es de solo lectura, por lo que puede
+     * llamarse en paralelo sobre partículas distintas.
+     *
      * @param p Partícula a transicionar
-     * @return Nueva posición (conjunto de k vértices)
+     * @return Intercambio a aplicar sobre p.current
+     */
+    Move transition(Particle& p) const;
+
+    /**
+     * Aplica S[pos] = vertex en el lugar, manteniendo members y el hash.
+     * No toca el árbol ni los valores de la partícula.
+     */
+    void apply_move(Particle& p, Move mv) const;
+
+    /**
+     * Aplica una transición a la partícula y actualiza su pbest.
+     */
+    void move_particle(Particle& p);
+
+    /**
+     * Peso del MST tras S[pos] = out_v, consultando la caché si está activa.
+     * @param hash hash Zobrist del conjunto actual
+     * @param hits, misses contadores del hilo que llama
+     */
+    double score_swap(IncrementalMST& tree, std::uint64_t hash, int pos, int in_v, int out_v,
+                      std::uint64_t& hits, std::uint64_t& misses) const;
+
+    /**
+     * run() con threads > 0 en una sola región paralela (ver set_threads).
+     */
+    void run_synchronous();
+
+    /** Llama al callback anytime (si hay) con un nuevo mejor conjunto. */
+    void notify(const std::vector<int>& set, double value) const;
+
+    /**
+     * Actualiza gbest con el mejor pbest del enjambre (en orden de índice).
+     * @return true si gbest mejoró
      */
-    std::vector<int> transition(const Particle& p) const;
+    bool update_gbest();
 
     /**
      * Calcula la diferencia entre dos conjuntos: a \ b
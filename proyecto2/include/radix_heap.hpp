@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <utility>
+
+/**
+ * Clase RadixHeap
+ * Cola de prioridad monótona (Ahuja, Mehlhorn, Orlin y Tarjan) para Dijkstra.
+ *
+ * Las claves son doubles no negativos: su representación IEEE-754 como
+ * uint64_t conserva el orden, así que se usan 65 cubetas indexadas por el
+ * bit más significativo en que la clave difiere de la última extraída.
+ * Push es O(1) y cada elemento se redistribuye a lo más 64 veces.
+ * Requiere que ninguna clave insertada sea menor que la última extraída.
+ */
+template <typename Value>
+class RadixHeap {
+public:
+    using Item = std::pair<std::uint64_t, Value>;
+
+    RadixHeap() : buckets_(65), last_(0), size_(0) {}
+
+    bool empty() const { return size_ == 0; }
+
+    void clear() {
+        for (auto& b : buckets_) b.clear();
+        last_ = 0;
+        size_ = 0;
+    }
+
+    void push(double key, Value value) {
+        std::uint64_t bits = to_bits(key);
+        buckets_[bucket(bits)].push_back({bits, value});
+        ++size_;
+    }
+
+    /** Extrae el elemento de menor clave. */
+    std::pair<double, Value> pop() {
+        if (buckets_[0].empty()) {
+            int i = 1;
+            while (buckets_[i].empty()) ++i;
+
+            std::uint64_t min_bits = buckets_[i][0].first;
+            for (const Item& it : buckets_[i])
+                if (it.first < min_bits) min_bits = it.first;
+
+            last_ = min_bits;
+            for (const Item& it : buckets_[i])
+                buckets_[bucket(it.first)].push_back(it);
+            buckets_[i].clear();
+        }
+
+        Item it = buckets_[0].back();
+        buckets_[0].pop_back();
+        --size_;
+        return {from_bits(it.first), it.second};
+    }
+
+private:
+    std::vector<std::vector<Item>> buckets_;
+    std::uint64_t last_;
+    std::size_t size_;
+
+    int bucket(std::uint64_t bits) const {
+        return bits == last_ ? 0 : 64 - __builtin_clzll(bits ^ last_);
+    }
+
+    static std::uint64_t to_bits(double d) {
+        std::uint64_t b;
+        std::memcpy(&b, &d, sizeof b);
+        return b;
+    }
+
+    static double from_bits(std::uint64_t b) {
+        double d;
+        std::memcpy(&d, &b, sizeof d);
+        return d;
+    }
+};
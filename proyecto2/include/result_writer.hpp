@@ -0,0 +1,97 @@
+#pragma once
+#include "graph.hpp"
+#include "mpmc_queue.hpp"
+#include <atomic>
+#include <fstream>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Clase ResultWriter
+ * Escribe los resultados de cada semilla desde un hilo dedicado.
+ *
+ * Los hilos de búsqueda solo encolan un registro (semilla, peso, conjunto y
+ * padres del MST) en una MpmcQueue; el hilo escritor le da formato y lo
+ * escribe. Así los hilos de OpenMP no abren archivos ni compiten por el
+ * sistema de archivos. El hilo escritor duerme en un semáforo mientras no
+ * hay resultados.
+ *
+ * FORMATOS:
+ * ---------
+ *   Files  un archivo kmst-<seed>.mst por semilla (formato original)
+ *   Jsonl  un solo kmst-results.jsonl, un objeto JSON por línea
+ *   Csv    un solo kmst-results.csv con encabezado
+ *
+ * En Jsonl y Csv los registros aparecen en el orden en que terminan las
+ * semillas, no en el orden de las semillas.
+ */
+class ResultWriter {
+public:
+    enum class Format { Files, Jsonl, Csv };
+
+    /**
+     * Resultado de una semilla.
+     */
+    struct Record {
+        unsigned seed = 0;
+        double value = 0.0;            // peso del MST (sin normalizar)
+        std::vector<int> set;          // IDs internos
+        std::vector<int> parent;       // padre local de cada posición (-1 = raíz)
+    };
+
+    /**
+     * Abre la salida y arranca el hilo escritor.
+     * @param graph grafo (para nombres, pesos y normalizador)
+     * @param format formato de salida
+     * @param directory directorio de salida (sin '/' final)
+     * @param prefix prefijo de los archivos (<prefix>-<seed>.mst, <prefix>-results.*)
+     * @throws std::runtime_error si no se puede abrir el archivo agregado
+     */
+    ResultWriter(const Graph& graph, Format format, const std::string& directory,
+                 const std::string& prefix = "kmst");
+
+    /** Vacía la cola y espera al hilo escritor. */
+    ~ResultWriter();
+
+    ResultWriter(const ResultWriter&) = delete;
+    ResultWriter& operator=(const ResultWriter&) = delete;
+
+    /** Encola un resultado (espera si la cola está llena). Seguro entre hilos. */
+    void submit(Record record);
+
+    /** Escribe lo pendiente y termina el hilo; llamadas posteriores no hacen nada. */
+    void close();
+
+    /** @return ruta del archivo agregado (vacía en modo Files). */
+    const std::string& path() const { return path_; }
+
+    /**
+     * Convierte "files", "jsonl" o "csv" en Format.
+     * @throws std::invalid_argument con cualquier otro valor
+     */
+    static Format parse_format(const std::string& name);
+
+private:
+    const Graph& graph_;
+    Format format_;
+    std::string directory_;
+    std::string prefix_;
+    std::string path_;
+    std::ofstream out_;
+    std::vector<char> buffer_;
+
+    // --- Cola: free_ cuenta lugares libres, ready_ registros listos (o el cierre) ---
+    MpmcQueue<Record> queue_;
+    std::counting_semaphore<> free_;
+    std::counting_semaphore<> ready_;
+    std::atomic<bool> done_;
+    std::thread thread_;
+
+    void loop();
+    void write(const Record& r);
+    void write_file(const Record& r);
+    void write_jsonl(const Record& r);
+    void write_csv(const Record& r);
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include "solver.hpp"
+#include "mpmc_queue.hpp"
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <semaphore>
+#include <string>
+#include <thread>
+#include <vector>
+
+class JsonValue;
+
+/**
+ * Clase Server
+ * Modo residente (kmst --serve): mantiene uno o más grafos preprocesados
+ * (un Solver por grafo) y atiende solicitudes de búsqueda en un socket Unix.
+ *
+ * PROTOCOLO:
+ * ----------
+ * Una solicitud por línea, un objeto JSON (mismo framing que JSONL):
+ *
+ *   {"id": "r1", "graph": "g3", "k": 40, "swarm": 20, "seeds": [1, 2],
+ *    "stagnation": 1000, "time": 2.0, "max_evals": 0, "target": 0.1,
+ *    "gap": 0.01, "neighbors": 16, "sweep": "first", "dlb": false,
+ *    "float32": false, "islands": "ring"}
+ *
+ * Solo "k" es obligatoria; "graph" puede omitirse si hay un solo grafo.
+ * Las respuestas también son líneas JSON con el mismo "id":
+ *
+ *   {"id":"r1","type":"seed",...}   una por semilla, al terminarla
+ *   {"id":"r1","type":"done",...}   mejor conjunto, aristas y tiempos
+ *   {"id":"r1","type":"error","message":"..."}
+ *
+ * PLANIFICACIÓN:
+ * --------------
+ * Cada conexión tiene un hilo lector que valida las solicitudes y las
+ * encola en una MpmcQueue acotada; un semáforo de lugares libres bloquea
+ * al lector cuando la cola está llena, así que un cliente que envía más
+ * rápido de lo que se atiende deja de ser leído (contrapresión del socket).
+ * Un pool fijo de trabajadores toma los trabajos; cada uno resuelve con
+ * omp_get_max_threads() / workers hilos de OpenMP para no sobresuscribir.
+ *
+ * Cada grafo conserva a lo sumo Options::prepared valores de k preparados
+ * (Solver::set_cache_limit) y los campos numéricos se validan contra
+ * límites fijos antes de construir el enjambre.
+ *
+ * Un cliente que no lee sus respuestas no puede detener a los trabajadores:
+ * los envíos tienen un límite de tiempo (SO_SNDTIMEO) y, al vencer, la
+ * conexión se marca rota, se cierra y sus respuestas se descartan.
+ */
+class Server {
+public:
+    struct Options {
+        int workers = 0;               // 0 = omp_get_max_threads()
+        std::size_t queue = 64;        // trabajos en espera antes de bloquear a los lectores
+        double send_timeout = 10.0;    // segundos que un envío puede bloquearse
+        std::size_t prepared = 8;      // k preparados que conserva cada grafo (LRU)
+    };
+
+    // --- Límites de una solicitud (evitan que un cliente agote la memoria) ---
+    static constexpr long long MAX_SWARM = 10000;
+    static constexpr long long MAX_SEEDS = 4096;
+    static constexpr long long MAX_ITERATIONS = 1000000000;
+
+    /**
+     * @param socket_path ruta del socket Unix (se reemplaza si existe)
+     */
+    Server(std::string socket_path, Options options);
+    ~Server();
+
+    Server(const Server&) = delete;
+    Server& operator=(const Server&) = delete;
+
+    /**
+     * Registra un grafo (pesos originales) con su identificador; calcula
+     * sus caminos mínimos. Debe llamarse antes de run().
+     * @throws std::invalid_argument si el identificador ya existe
+     */
+    void add_graph(const std::string& id, Graph graph);
+
+    /**
+     * Atiende conexiones hasta recibir SIGINT o SIGTERM; al terminar deja
+     * de leer, responde los trabajos pendientes y borra el socket.
+     * @throws std::runtime_error si no se puede abrir el socket
+     */
+    void run();
+
+private:
+    struct Connection;
+
+    struct Job {
+        std::shared_ptr<Connection> connection;
+        std::string id;
+        const Solver* solver = nullptr;
+        Solver::Request request;
+        std::chrono::steady_clock::time_point queued;
+    };
+
+    std::string socket_path_;
+    Options options_;
+    std::map<std::string, std::unique_ptr<Solver>> solvers_;
+
+    // --- Cola de trabajos: free_ cuenta lugares libres, ready_ trabajos listos ---
+    MpmcQueue<std::unique_ptr<Job>> queue_;
+    std::counting_semaphore<> free_;
+    std::counting_semaphore<> ready_;
+
+    std::vector<std::thread> workers_;
+    std::mutex connections_mutex_;
+    std::vector<std::pair<std::shared_ptr<Connection>, std::thread>> connections_;
+
+    void serve(std::shared_ptr<Connection> connection);
+    void submit(std::unique_ptr<Job> job);
+    void work(int threads);
+    void execute(Job& job);
+
+    std::unique_ptr<Job> make_job(const JsonValue& message) const;
+};
@@ -0,0 +1,217 @@
+#pragma once
+#include "graph.hpp"
+#include "pso.hpp"
+#include "islands.hpp"
+#include "telemetry.hpp"
+#include "lower_bounds.hpp"
+#include <functional>
+#include <limits>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+class CandidateLists;
+class SubsetCache;
+
+/**
+ * Clase Solver
+ * Fachada de libkmst: comparte un grafo preprocesado entre muchas
+ * solicitudes de k-MST concurrentes.
+ *
+ * El grafo base (pesos originales, caminos mínimos y diámetro) es inmutable
+ * tras el constructor y no depende de k. La completación y el normalizador
+ * sí dependen de k: cada k se prepara una sola vez con Graph::completed(k)
+ * (una pasada O(n²), sin volver a calcular caminos mínimos) y se guarda
+ * como shared_ptr<const Graph>; las listas de vecinos se guardan por k.
+ * Las cotas inferiores se guardan por k. Los mapas están protegidos por un
+ * mutex y solo se tocan al inicio de solve().
+ *
+ * Cada k preparado ocupa una matriz n×n (más su copia float y sus listas).
+ * Con set_cache_limit(N) se conservan solo los N k usados más recientemente;
+ * release(k) los descarta de inmediato. Las solicitudes en curso conservan
+ * sus shared_ptr, así que desalojar un k nunca invalida una búsqueda.
+ *
+ * Con Request::single_precision la búsqueda lee una copia float de la
+ * matriz (guardada por k, ver PSO::set_single_precision) y el peso de
+ * cada resultado se recalcula en double con prim_subset_full.
+ *
+ * Si se sabe que solo se usará un k, Solver(graph, k) completa el grafo en
+ * su lugar: base y grafo preparado son la misma matriz.
+ *
+ * Cada semilla se detiene si su gbest alcanza la cota (óptimo demostrado).
+ * Con Request::gap > 0, todas las semillas se detienen en cuanto una alcanza
+ * f(gbest) <= cota / (1 - gap).
+ *
+ * solve() es const y segura entre hilos: no usa variables globales ni
+ * escribe en stdout; todo el estado de la búsqueda vive en la solicitud.
+ *
+ * Con Request::threads > 0 las semillas (o los k de solve_batch) y las
+ * partículas de cada enjambre son dos niveles de OpenMP y el pool se divide
+ * entre ambos. Solver no cambia ajustes de todo el proceso: quien lo usa
+ * debe permitir dos niveles activos (omp_set_max_active_levels(2), como
+ * kmst); si no, cada enjambre corre en un solo hilo.
+ */
+class Solver {
+public:
+    /**
+     * Resultado de una semilla (o isla).
+     */
+    struct SeedResult {
+        int k = 0;
+        unsigned seed = 0;
+        int thread = -1;               // hilo de OpenMP que la ejecutó (-1 = varios)
+        double value = std::numeric_limits<double>::infinity();
+        double normalized = std::numeric_limits<double>::infinity();
+        std::vector<int> set;          // IDs internos
+        std::vector<int> parent;       // padre local de cada posición (-1 = raíz)
+        telemetry::SearchStats stats;
+    };
+
+    /**
+     * Se llama al terminar cada semilla, desde el hilo que la ejecutó.
+     */
+    using ResultCallback = std::function<void(const SeedResult&)>;
+
+    /**
+     * Solicitud de búsqueda: k, presupuesto y semillas.
+     */
+    struct Request {
+        int k = 0;
+        int swarm_size = 20;
+        int stagnation = 10000;        // iteraciones sin mejora antes de detenerse
+        std::vector<unsigned> seeds;
+
+        // --- Presupuesto por semilla (0 = sin límite) ---
+        double seconds = 0.0;
+        long long evaluations = 0;
+        double target = -std::numeric_limits<double>::infinity();  // normalizado
+        double gap = 0.0;              // detener todas las semillas con brecha <= gap
+
+        // --- Paralelismo ---
+        int threads = 0;               // hilos por enjambre (0 = semillas en paralelo)
+        bool islands = false;          // una isla por semilla
+        IslandModel::Topology topology = IslandModel::Topology::Ring;
+        int migrate_every = 100;
+
+        // --- Búsqueda local y vecindario ---
+        PSO::SweepPolicy sweep = PSO::SweepPolicy::First;
+        bool dlb = false;
+        int neighbors = 0;             // 0 = vecindario completo
+        bool single_precision = false; // buscar con pesos float; resultados en double
+
+        // --- Opcionales del llamador ---
+        bool telemetry = false;
+        SubsetCache* cache = nullptr;  // compartible entre k (los conjuntos difieren en tamaño)
+        PSO::AnytimeCallback anytime;  // recibe pesos sin normalizar
+        ResultCallback on_result;
+    };
+
+    /**
+     * Resultado de una solicitud.
+     */
+    struct Result {
+        SeedResult best;               // menor peso; en empate, la primera semilla
+        std::vector<SeedResult> runs;  // en el orden de Request::seeds
+        double normalizer = 1.0;
+        double lower_bound = 0.0;      // LowerBounds::value(), sin normalizar
+        double gap = 0.0;              // brecha relativa de best respecto a lower_bound
+    };
+
+    /**
+     * Toma el grafo base (pesos originales) y calcula sus caminos mínimos
+     * si aún no los tiene.
+     *
+     * @param only_k si es > 0, el Solver queda fijo para ese k: el grafo se
+     *        completa en su lugar, sin la copia por k, y prepare() con otro
+     *        k lanza std::invalid_argument
+     * @throws std::invalid_argument si only_k > n
+     */
+    explicit Solver(Graph graph, int only_k = 0);
+
+    Solver(const Solver&) = delete;
+    Solver& operator=(const Solver&) = delete;
+
+    /** @return grafo base (sin completar, salvo con un solo k). */
+    const Graph& graph() const { return *base_; }
+
+    /**
+     * Grafo completado y normalizado para k; se construye en la primera
+     * llamada con ese k y se comparte en las siguientes.
+     * @throws std::invalid_argument si k no está en [1, n]
+     */
+    std::shared_ptr<const Graph> prepare(int k) const;
+
+    /**
+     * Ejecuta la búsqueda para todas las semillas de la solicitud.
+     * Puede llamarse desde varios hilos a la vez.
+     * @throws std::invalid_argument si la solicitud no es válida
+     */
+    Result solve(const Request& request) const;
+
+    /**
+     * Resuelve la misma solicitud para varios k, en paralelo sobre el pool
+     * de OpenMP (un k por hilo; las semillas de cada k corren en ese hilo).
+     * Request::k se ignora; SeedResult::k identifica cada resultado en
+     * los callbacks.
+     * @return un resultado por k, en el orden de ks
+     */
+    std::vector<Result> solve_batch(const Request& request, const std::vector<int>& ks) const;
+
+    /**
+     * Conserva a lo sumo `ks` valores de k preparados (LRU; 0 = sin límite,
+     * el valor inicial). No es seguro llamarlo junto con solve().
+     */
+    void set_cache_limit(std::size_t ks);
+
+    /**
+     * Descarta el grafo preparado de k y todo lo derivado de él; quien aún
+     * tenga el shared_ptr lo conserva hasta soltarlo. Sin efecto con only_k.
+     */
+    void release(int k) const;
+
+    /**
+     * Listas de los M vecinos más cercanos sobre el grafo preparado para k;
+     * se construyen una vez por k y se comparten como prepare() (pedir otro
+     * M para el mismo k reemplaza las listas guardadas).
+     */
+    std::shared_ptr<const CandidateLists> candidate_lists(int k, int m) const;
+
+    /**
+     * Cotas inferiores del k-MST sobre el grafo preparado para k; se
+     * calculan una vez por k y se comparten como prepare().
+     */
+    std::shared_ptr<const LowerBounds> lower_bounds(int k) const;
+
+    /**
+     * Copia en precisión simple del grafo preparado para k; se construye
+     * una vez por k y se comparte como prepare().
+     */
+    std::shared_ptr<const DenseMatrix32> single_precision(int k) const;
+
+private:
+    std::shared_ptr<const Graph> base_;
+    int only_k_ = 0;               // > 0: base_ ya está completado para ese k
+
+    mutable std::mutex mutex_;
+    mutable std::map<int, std::shared_ptr<const Graph>> prepared_;
+    mutable std::map<int, std::pair<int, std::shared_ptr<const CandidateLists>>> candidates_;
+    mutable std::map<int, std::shared_ptr<const LowerBounds>> bounds_;
+    mutable std::map<int, std::shared_ptr<const DenseMatrix32>> singles_;
+    mutable std::list<int> recent_;   // k preparados, del más reciente al más antiguo
+    std::size_t limit_ = 0;
+
+    // Con mutex_ tomado
+    void touch(int k) const;
+    void evict() const;
+    void forget(int k) const;
+
+    void run_islands(const Graph& g, const Request& request, const PSO::Limits& limits,
+                     const CandidateLists* candidates, const DenseMatrix32* single,
+                     std::vector<SeedResult>& runs) const;
+    void run_seeds(const Graph& g, const Request& request, const PSO::Limits& limits,
+                   const CandidateLists* candidates, const DenseMatrix32* single,
+                   std::vector<SeedResult>& runs) const;
+};
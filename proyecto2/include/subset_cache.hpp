@@ -0,0 +1,67 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+/**
+ * Clase SubsetCache
+ * Memoria de pesos de MST por subconjunto de vértices, compartida entre
+ * hilos y enjambres.
+ *
+ * HASH (Zobrist):
+ * ---------------
+ * Cada vértice v tiene una clave aleatoria de 64 bits z[v]; el hash de S es
+ * el XOR de las claves de sus vértices. No depende del orden y un
+ * intercambio S - u + v se actualiza en O(1):  h' = h ^ z[u] ^ z[v].
+ *
+ * TABLA:
+ * ------
+ * Tabla de tamaño fijo (potencia de 2), direccionada por los bits bajos del
+ * hash, sin candados y con pérdida: una escritura siempre reemplaza lo que
+ * había en la casilla. Cada casilla guarda (hash ^ valor, valor); una
+ * lectura solo se acepta si el XOR reconstruye el hash buscado, así una
+ * casilla escrita a medias por otro hilo se descarta como fallo.
+ *
+ * La tabla no cuenta aciertos ni fallos: un contador compartido sería una
+ * línea de caché disputada por todos los hilos en cada consulta. Cada
+ * partícula lleva los suyos (telemetry::Counters) y se suman al reportar.
+ */
+class SubsetCache {
+public:
+    /**
+     * @param n número de vértices del grafo
+     * @param megabytes memoria máxima de la tabla
+     * @param seed semilla de las claves Zobrist
+     */
+    SubsetCache(int n, std::size_t megabytes, std::uint64_t seed = 0x6b6d7374ULL);
+
+    /** @return clave Zobrist del vértice v. */
+    std::uint64_t token(int v) const { return zobrist_[v]; }
+
+    /** @return hash del subconjunto (XOR de las claves de sus vértices). */
+    std::uint64_t hash(const std::vector<int>& vertices) const;
+
+    /**
+     * Busca el peso del MST del subconjunto con hash h.
+     * @return true si estaba en la tabla (value queda asignado)
+     */
+    bool lookup(std::uint64_t h, double& value) const;
+
+    /** Guarda el peso del MST del subconjunto con hash h. */
+    void store(std::uint64_t h, double value);
+
+    /** @return número de casillas de la tabla. */
+    std::size_t slots() const { return mask_ + 1; }
+
+private:
+    struct Slot {
+        std::atomic<std::uint64_t> check;   // hash ^ bits(valor)
+        std::atomic<std::uint64_t> value;   // bits(valor)
+    };
+
+    std::vector<std::uint64_t> zobrist_;
+    std::unique_ptr<Slot[]> table_;
+    std::size_t mask_;
+};
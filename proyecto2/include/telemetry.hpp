@@ -0,0 +1,109 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+class SubsetCache;
+
+/**
+ * Telemetría del solver: contadores de búsqueda, cronómetro de fases y
+ * reporte JSON de la corrida.
+ *
+ * Los contadores del ciclo PSO viven en cada partícula (solo un hilo la
+ * mueve a la vez), así que el camino crítico no usa atomics; se suman al
+ * final con PSO::stats(). Con la telemetría desactivada el costo es una
+ * rama predecible por movimiento.
+ */
+namespace telemetry {
+
+/** Rama de transition() que originó un movimiento. */
+enum Branch : int {
+    GBEST = 0,
+    PBEST = 1,
+    RANDOM = 2
+};
+constexpr int BRANCHES = 3;
+
+/** @return "gbest", "pbest" o "random". */
+const char* branch_name(int branch);
+
+/**
+ * Contadores por rama de transición y de consultas a la caché.
+ */
+struct Counters {
+    std::uint64_t proposals[BRANCHES] = {};      // transiciones
+    std::uint64_t no_candidates[BRANCHES] = {};  // sin vértice que proponer
+    std::uint64_t accepted[BRANCHES] = {};       // el movimiento mejoró current
+    std::uint64_t pbest_updates[BRANCHES] = {};  // el movimiento mejoró pbest
+
+    // SubsetCache::lookup (todas las ramas y sweep); se cuentan aunque la
+    // telemetría esté desactivada
+    std::uint64_t cache_hits = 0;
+    std::uint64_t cache_misses = 0;
+
+    Counters& operator+=(const Counters& other);
+};
+
+/**
+ * Estadísticas de una corrida de PSO (una semilla o isla).
+ */
+struct SearchStats {
+    Counters counters;
+    std::uint64_t evaluations = 0;
+    std::uint64_t gbest_improvements = 0;
+    std::uint64_t sweep_moves = 0;        // intercambios aplicados por sweep()
+    double search_seconds = 0.0;          // initialize() hasta el inicio de sweep()
+    double sweep_seconds = 0.0;
+};
+
+/**
+ * Resultado y estadísticas de una semilla para el reporte.
+ */
+struct SeedReport {
+    unsigned seed = 0;
+    int thread = -1;                      // hilo que la ejecutó (-1 = varios)
+    double value = 0.0;
+    double normalized = 0.0;
+    SearchStats stats;
+};
+
+/**
+ * Cronómetro de fases secuenciales: start() cierra la fase anterior.
+ */
+class PhaseTimer {
+public:
+    void start(const std::string& phase);
+    void stop();
+
+    /** @return (fase, segundos) en orden de inicio. */
+    const std::vector<std::pair<std::string, double>>& phases() const { return phases_; }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    std::vector<std::pair<std::string, double>> phases_;
+    Clock::time_point begin_;
+    bool running_ = false;
+};
+
+/**
+ * Parámetros de la corrida que se copian al reporte.
+ */
+struct RunInfo {
+    std::string input;
+    int k = 0;
+    int swarm_size = 0;
+    int threads = 0;
+    bool islands = false;
+};
+
+/**
+ * Escribe el reporte JSON: parámetros, fases, una entrada por semilla,
+ * un resumen por hilo (evaluaciones por segundo) y la caché si se usó.
+ */
+void write_report(std::ostream& out, const RunInfo& info, const PhaseTimer& phases,
+                  const std::vector<SeedReport>& seeds, const SubsetCache* cache);
+
+}
@@ -0,0 +1,29 @@
+#include "../include/candidate_lists.hpp"
+#include <algorithm>
+#include <numeric>
+
+CandidateLists::CandidateLists(const Graph& graph, int m) {
+    const int n = graph.num_vertices();
+    const auto& adj = graph.adjacency();
+    m_ = std::max(0, std::min(m, n - 1));
+    lists_.resize((size_t)n * m_);
+
+    #pragma omp parallel
+    {
+        std::vector<int> order(n);
+
+        #pragma omp for schedule(dynamic, 16)
+        for (int v = 0; v < n; ++v) {
+            const double* row = adj[v];
+            std::iota(order.begin(), order.end(), 0);
+
+            // v queda fuera de su propia lista
+            std::swap(order[v], order[n - 1]);
+            auto closer = [row](int a, int b) {
+                return row[a] < row[b] || (row[a] == row[b] && a < b);
+            };
+            std::partial_sort(order.begin(), order.begin() + m_, order.begin() + (n - 1), closer);
+            std::copy(order.begin(), order.begin() + m_, lists_.begin() + (size_t)v * m_);
+        }
+    }
+}
@@ -0,0 +1,140 @@
+#include "../include/graph_cache.hpp"
+#include "../include/mapped_file.hpp"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <sys/stat.h>
+
+static constexpr char MAGIC[8] = {'K', 'M', 'S', 'T', 'B', 'I', 'N', '\0'};
+
+// Registro de arista en disco (16 bytes, sin relleno)
+struct EdgeRecord {
+    std::uint32_t u;
+    std::uint32_t v;
+    double w;
+};
+static_assert(sizeof(EdgeRecord) == 16);
+
+std::string GraphCache::path_for(const std::string& source) {
+    return source + ".kmstbin";
+}
+
+std::uint64_t GraphCache::checksum(const char* data, std::size_t size) {
+    std::uint64_t h = 1469598103934665603ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+void GraphCache::write(const Graph& g, const std::string& source, const std::string& cache_path) {
+    if (!g.has_distances())
+        throw std::runtime_error("GraphCache: el grafo no tiene distancias calculadas");
+
+    MappedFile src(source);
+    const int n = g.num_vertices();
+
+    std::string names;
+    for (const std::string& name : g.vertex_names()) {
+        std::uint32_t len = name.size();
+        names.append(reinterpret_cast<const char*>(&len), sizeof len);
+        names.append(name);
+    }
+    names.resize((names.size() + 7) / 8 * 8, '\0');
+
+    Header h{};
+    std::memcpy(h.magic, MAGIC, sizeof MAGIC);
+    h.version = VERSION;
+    h.n = n;
+    h.m = g.num_edges();
+    h.edges = g.edges().size();
+    h.source_size = src.size();
+    h.source_hash = checksum(src.data(), src.size());
+    h.diameter = g.diameter();
+    h.names_bytes = names.size();
+
+    std::ofstream out(cache_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("No se pudo escribir la caché: " + cache_path);
+
+    out.write(reinterpret_cast<const char*>(&h), sizeof h);
+    out.write(names.data(), names.size());
+    for (const Graph::Edge& e : g.edges()) {
+        EdgeRecord r{static_cast<std::uint32_t>(e.u), static_cast<std::uint32_t>(e.v), e.w};
+        out.write(reinterpret_cast<const char*>(&r), sizeof r);
+    }
+    for (int i = 0; i < n; ++i)
+        out.write(reinterpret_cast<const char*>(g.distances()[i]), n * sizeof(double));
+
+    if (!out)
+        throw std::runtime_error("Error escribiendo la caché: " + cache_path);
+}
+
+std::optional<Graph> GraphCache::load(const std::string& source, const std::string& cache_path) {
+    struct stat st;
+    if (::stat(cache_path.c_str(), &st) != 0)
+        return std::nullopt;
+
+    MappedFile file(cache_path);
+    if (file.size() < sizeof(Header))
+        return std::nullopt;
+
+    Header h;
+    std::memcpy(&h, file.data(), sizeof h);
+    if (std::memcmp(h.magic, MAGIC, sizeof MAGIC) != 0 || h.version != VERSION)
+        return std::nullopt;
+
+    // Cada sección se acota con lo que queda del archivo antes de
+    // multiplicar: un encabezado corrupto no puede desbordar el tamaño
+    // esperado y hacer pasar la comprobación
+    const std::size_t n = h.n;
+    std::size_t rest = file.size() - sizeof h;
+    if (h.names_bytes > rest)
+        return std::nullopt;
+    rest -= h.names_bytes;
+    if (h.edges > rest / sizeof(EdgeRecord))
+        return std::nullopt;
+    rest -= h.edges * sizeof(EdgeRecord);
+    if (n > 0 && n > rest / sizeof(double) / n)
+        return std::nullopt;
+    if (rest != n * n * sizeof(double))
+        return std::nullopt;
+
+    // La caché solo es válida para el contenido actual del archivo fuente
+    MappedFile src(source);
+    if (src.size() != h.source_size || checksum(src.data(), src.size()) != h.source_hash)
+        return std::nullopt;
+
+    const char* p = file.data() + sizeof h;
+    const char* names_end = p + h.names_bytes;
+    std::vector<std::string> names;
+    names.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint32_t len;
+        if (p + sizeof len > names_end) return std::nullopt;
+        std::memcpy(&len, p, sizeof len);
+        p += sizeof len;
+        if (p + len > names_end) return std::nullopt;
+        names.emplace_back(p, len);
+        p += len;
+    }
+    p = names_end;
+
+    Graph g(std::move(names));
+    g.m = h.m;
+    g.diameter_ = h.diameter;
+    g.edges_.resize(h.edges);
+    for (std::size_t i = 0; i < h.edges; ++i, p += sizeof(EdgeRecord)) {
+        EdgeRecord r;
+        std::memcpy(&r, p, sizeof r);
+        if (r.u >= r.v || r.v >= n) return std::nullopt;
+        g.edges_[i] = {static_cast<int>(r.u), static_cast<int>(r.v), r.w};
+    }
+    // La matriz de Graph(names) recibe directamente las distancias
+    for (std::size_t i = 0; i < n; ++i, p += n * sizeof(double))
+        std::memcpy(g.adj[i], p, n * sizeof(double));
+    g.state_ = Graph::State::Distances;
+
+    return g;
+}
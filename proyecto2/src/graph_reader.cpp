@@ -1,66 +1,93 @@
 #include "../include/graph_reader.hpp"
-#include <sstream>
-#include <algorithm>
-#include <cctype>
+#include "../include/mapped_file.hpp"
+#include <charconv>
+#include <string_view>
+#include <unordered_map>
 #include <iostream>
 
 Graph GraphReader::from_file(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        throw std::runtime_error("No se pudo abrir el archivo: " + filename);
-    }
-    return from_stream(file);
+    MappedFile file(filename);
+    return from_buffer(file.data(), file.size());
 }
 
 Graph GraphReader::from_stream(std::istream& input) {
     std::string content((std::istreambuf_iterator<char>(input)),
                          std::istreambuf_iterator<char>());
+    return from_buffer(content.data(), content.size());
+}
 
-    // eliminar saltos de línea y retornos
-    content.erase(std::remove(content.begin(), content.end(), '\n'), content.end());
-    content.erase(std::remove(content.begin(), content.end(), '\r'), content.end());
+static std::string_view trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '\r'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r'))
+        s.remove_suffix(1);
+    return s;
+}
 
-    Graph g;
+Graph GraphReader::from_buffer(const char* data, std::size_t size) {
+    struct Edge {
+        int u, v;
+        double w;
+    };
 
-    size_t pos = 0;
-    while (true) {
-        // buscar primer vértice (V...)
-        size_t start = content.find('V', pos);
-        if (start == std::string::npos) break;
+    // Primera pasada: internar nombres y guardar aristas por ID
+    std::unordered_map<std::string_view, int> ids;
+    std::vector<std::string_view> names;
+    std::vector<Edge> edges;
+    edges.reserve(size / 16);
 
-        size_t comma1 = content.find(',', start);
-        if (comma1 == std::string::npos) break;
+    auto intern = [&](std::string_view name) {
+        auto [it, inserted] = ids.try_emplace(name, (int)names.size());
+        if (inserted) names.push_back(name);
+        return it->second;
+    };
 
-        size_t v_start = content.find('V', comma1 + 1);
-        if (v_start == std::string::npos) break;
+    const char* p = data;
+    const char* end = data + size;
+    std::size_t line = 1;
 
-        size_t comma2 = content.find(',', v_start);
-        if (comma2 == std::string::npos) break;
+    while (p < end) {
+        // Registro: hasta ';' o fin de línea
+        const char* rec = p;
+        while (p < end && *p != ';' && *p != '\n') ++p;
+        std::string_view record(rec, p - rec);
+        std::size_t record_line = line;
+        if (p < end && *p == '\n') ++line;
+        ++p;
 
-        std::string u = content.substr(start, comma1 - start);
-        std::string v = content.substr(v_start, comma2 - v_start);
+        record = trim(record);
+        if (record.empty()) continue;
 
-        // buscar inicio del siguiente V (para cortar el peso)
-        size_t next_v = content.find('V', comma2 + 1);
-        std::string w_str = (next_v == std::string::npos)
-                            ? content.substr(comma2 + 1)
-                            : content.substr(comma2 + 1, next_v - comma2 - 1);
+        std::size_t c1 = record.find(',');
+        std::size_t c2 = (c1 == std::string_view::npos) ? c1 : record.find(',', c1 + 1);
+        bool ok = (c2 != std::string_view::npos);
 
-        auto trim = [](std::string &s) {
-            s.erase(0, s.find_first_not_of(" \t"));
-            s.erase(s.find_last_not_of(" \t") + 1);
-        };
-        trim(u); trim(v); trim(w_str);
+        std::string_view u, v, w_str;
+        double w = 0.0;
+        if (ok) {
+            u = trim(record.substr(0, c1));
+            v = trim(record.substr(c1 + 1, c2 - c1 - 1));
+            w_str = trim(record.substr(c2 + 1));
+            auto [ptr, ec] = std::from_chars(w_str.data(), w_str.data() + w_str.size(), w);
+            ok = !u.empty() && !v.empty() && ec == std::errc() &&
+                 ptr == w_str.data() + w_str.size();
+        }
 
-        try {
-            double w = std::stod(w_str);
-            g.add_edge(u, v, w);
-        } catch (...) {
-            std::cerr << "[WARN] Error parseando arista: " << u << "," << v << "," << w_str << "\n";
+        if (!ok) {
+            std::cerr << "[WARN] Error parseando arista (línea " << record_line
+                      << "): " << record << "\n";
+            continue;
         }
 
-        pos = (next_v == std::string::npos) ? content.size() : next_v;
+        int uid = intern(u);
+        int vid = intern(v);
+        edges.push_back({uid, vid, w});
     }
 
+    // Segunda fase: reservar la matriz una sola vez y llenarla
+    Graph g(std::vector<std::string>(names.begin(), names.end()));
+    for (const Edge& e : edges)
+        g.add_edge(e.u, e.v, e.w);
+
     return g;
 }
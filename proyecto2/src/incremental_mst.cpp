@@ -0,0 +1,224 @@
+#include "../include/incremental_mst.hpp"
+#include "../include/prim_kernel.hpp"
+#include <algorithm>
+
+IncrementalMST::IncrementalMST()
+    : graph_(nullptr), single_(nullptr), total_(0.0), base_pos_(-1) {}
+
+IncrementalMST::IncrementalMST(const Graph& graph, const DenseMatrix32* single)
+    : graph_(&graph), single_(single), total_(0.0), base_pos_(-1) {}
+
+double IncrementalMST::prim_local(int skip, std::vector<Edge>& out) {
+    if (single_)
+        return prim_rows(*single_, key32_, skip, out);
+    return prim_rows(graph_->adjacency(), key_, skip, out);
+}
+
+template <typename T>
+double IncrementalMST::prim_rows(const BasicDenseMatrix<T>& adj, std::vector<T>& key,
+                                 int skip, std::vector<Edge>& out) {
+    const int k = verts_.size();
+
+    rem_.resize(k);
+    ids_.resize(k);
+    key.resize(k);
+    par_.resize(k);
+    out.clear();
+
+    int u = (skip == 0) ? 1 : 0;
+    if (u >= k) return 0.0;
+
+    int r = 0;
+    for (int x = 0; x < k; ++x) {
+        if (x == skip || x == u) continue;
+        rem_[r] = x;
+        ids_[r] = verts_[x];
+        key[r] = std::numeric_limits<T>::infinity();
+        par_[r] = u;
+        ++r;
+    }
+
+    double total = 0.0;
+    while (r > 0) {
+        int j = prim_kernel::relax_argmin_parent(adj[verts_[u]], ids_.data(),
+                                                 key.data(), par_.data(), u, r);
+        u = rem_[j];
+        out.push_back({par_[j], u, key[j]});
+        total += key[j];
+
+        --r;
+        rem_[j] = rem_[r];
+        ids_[j] = ids_[r];
+        key[j] = key[r];
+        par_[j] = par_[r];
+    }
+    return total;
+}
+
+void IncrementalMST::refresh_degrees() {
+    deg_.assign(verts_.size(), 0);
+    for (const Edge& e : edges_) {
+        ++deg_[e.a];
+        ++deg_[e.b];
+    }
+}
+
+void IncrementalMST::neighbors(int pos, std::vector<int>& out) const {
+    out.clear();
+    for (const Edge& e : edges_) {
+        if (e.a == pos) out.push_back(e.b);
+        else if (e.b == pos) out.push_back(e.a);
+    }
+}
+
+double IncrementalMST::build(const std::vector<int>& vertices) {
+    verts_ = vertices;
+    total_ = prim_local(-1, edges_);
+    refresh_degrees();
+    base_pos_ = -1;
+    return total_;
+}
+
+void IncrementalMST::prepare_base(int pos) {
+    const int k = verts_.size();
+    base_pos_ = pos;
+
+    // MST(S - u): hoja → basta quitar su arista; si no, Prim sobre k - 1
+    if (deg_[pos] <= 1) {
+        base_edges_.clear();
+        for (const Edge& e : edges_)
+            if (e.a != pos && e.b != pos)
+                base_edges_.push_back(e);
+    } else {
+        prim_local(pos, base_edges_);
+    }
+
+    // Lista de adyacencia del árbol base
+    head_.assign(k, -1);
+    next_.resize(2 * base_edges_.size());
+    to_.resize(2 * base_edges_.size());
+    int slot = 0;
+    for (const Edge& e : base_edges_) {
+        to_[slot] = e.b; next_[slot] = head_[e.a]; head_[e.a] = slot++;
+        to_[slot] = e.a; next_[slot] = head_[e.b]; head_[e.b] = slot++;
+    }
+
+    // Preorden desde cualquier posición distinta de pos
+    order_.clear();
+    bparent_.assign(k, -1);
+    bweight_.assign(k, 0.0);
+    if (k < 2) return;
+
+    int root = (pos == 0) ? 1 : 0;
+    order_.push_back(root);
+    for (size_t i = 0; i < order_.size(); ++i) {
+        int x = order_[i];
+        for (int s = head_[x]; s != -1; s = next_[s]) {
+            int y = to_[s];
+            if (y == bparent_[x]) continue;
+            bparent_[y] = x;
+            bweight_[y] = weight(verts_[x], verts_[y]);
+            order_.push_back(y);
+        }
+    }
+}
+
+template <typename T>
+void IncrementalMST::load_row(const T* row) {
+    const int k = verts_.size();
+    for (int x : order_) {
+        double w = row[verts_[x]];
+        zw_[x] = w;
+        mw_[x] = w;
+        mid_[x] = k + x;
+    }
+}
+
+double IncrementalMST::insert_vertex(int v) {
+    const int k = verts_.size();
+
+    zw_.resize(k);
+    mw_.resize(k);
+    mid_.resize(k);
+    deleted_.assign(2 * k, 0);
+
+    if (single_)
+        load_row((*single_)[v]);
+    else
+        load_row(graph_->adjacency()[v]);
+
+    // Postorden (preorden invertido): cada x ya tiene su mejor camino a v
+    for (size_t i = order_.size(); i-- > 1;) {
+        int x = order_[i];
+        int p = bparent_[x];
+
+        // Camino p - x ~> v: su arista más pesada
+        double cw = bweight_[x];
+        int cid = x;
+        if (mw_[x] > cw) {
+            cw = mw_[x];
+            cid = mid_[x];
+        }
+
+        if (cw < mw_[p]) {
+            deleted_[mid_[p]] = 1;
+            mw_[p] = cw;
+            mid_[p] = cid;
+        } else {
+            deleted_[cid] = 1;
+        }
+    }
+
+    // Se suman solo las aristas conservadas (mismo orden que commit_swap);
+    // restar las eliminadas pierde precisión con pesos de completación grandes
+    double total = 0.0;
+    for (size_t i = 1; i < order_.size(); ++i)
+        if (!deleted_[order_[i]]) total += bweight_[order_[i]];
+    for (int x : order_)
+        if (!deleted_[k + x]) total += zw_[x];
+    return total;
+}
+
+double IncrementalMST::evaluate_swap(int pos, int v) {
+    if (base_pos_ != pos)
+        prepare_base(pos);
+    return insert_vertex(v);
+}
+
+double IncrementalMST::commit_swap(int pos, int v) {
+    // Sin base preparada y u interno: un Prim completo cuesta lo mismo
+    // que Prim sobre S - u más la inserción
+    if (base_pos_ != pos && deg_[pos] > 1) {
+        verts_[pos] = v;
+        total_ = prim_local(-1, edges_);
+        refresh_degrees();
+        base_pos_ = -1;
+        return total_;
+    }
+
+    if (base_pos_ != pos)
+        prepare_base(pos);
+    insert_vertex(v);
+
+    const int k = verts_.size();
+    edges_.clear();
+    total_ = 0.0;
+    for (size_t i = 1; i < order_.size(); ++i) {
+        int x = order_[i];
+        if (!deleted_[x]) {
+            edges_.push_back({bparent_[x], x, bweight_[x]});
+            total_ += bweight_[x];
+        }
+    }
+    for (int x : order_) {
+        if (!deleted_[k + x]) {
+            edges_.push_back({pos, x, zw_[x]});
+            total_ += zw_[x];
+        }
+    }
+
+    verts_[pos] = v;
+    refresh_degrees();
+    base_pos_ = -1;
+    return total_;
+}
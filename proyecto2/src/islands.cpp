@@ -0,0 +1,129 @@
+#include "../include/islands.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+IslandModel::IslandModel(const Graph& graph, int k, int swarm_size, int iterations,
+                         const std::vector<unsigned>& seeds, Topology topology, int interval)
+    : topology_(topology),
+      iterations_(iterations),
+      interval_(std::max(1, interval)),
+      stagnation_(seeds.size(), 0),
+      outbox_(seeds.size()),
+      outbox_value_(seeds.size())
+{
+    islands_.reserve(seeds.size());
+    for (unsigned seed : seeds)
+        islands_.emplace_back(graph, k, swarm_size, iterations, 0.6, 0.3, seed);
+
+    for (auto& box : outbox_)
+        box.reserve(k);
+}
+
+IslandModel::Topology IslandModel::parse_topology(const std::string& name) {
+    if (name == "ring") return Topology::Ring;
+    if (name == "all") return Topology::AllToAll;
+    throw std::invalid_argument("Topología desconocida: " + name + " (use ring o all)");
+}
+
+void IslandModel::set_cache(SubsetCache* cache) {
+    for (auto& island : islands_)
+        island.set_cache(cache);
+}
+
+void IslandModel::set_candidates(const CandidateLists* candidates) {
+    for (auto& island : islands_)
+        island.set_candidates(candidates);
+}
+
+void IslandModel::set_single_precision(const DenseMatrix32* weights) {
+    for (auto& island : islands_)
+        island.set_single_precision(weights);
+}
+
+void IslandModel::set_limits(const PSO::Limits& limits) {
+    for (auto& island : islands_)
+        island.set_limits(limits);
+}
+
+void IslandModel::set_anytime(const PSO::AnytimeCallback& callback) {
+    for (auto& island : islands_)
+        island.set_anytime(callback);
+}
+
+void IslandModel::set_telemetry(bool enabled) {
+    for (auto& island : islands_)
+        island.set_telemetry(enabled);
+}
+
+void IslandModel::set_sweep(PSO::SweepPolicy policy, bool dont_look_bits) {
+    for (auto& island : islands_)
+        island.set_sweep(policy, dont_look_bits);
+}
+
+void IslandModel::run() {
+    const int N = islands_.size();
+
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < N; ++i)
+        islands_[i].initialize();
+
+    bool done = (N == 0);
+
+    #pragma omp parallel
+    {
+        while (!done) {
+            #pragma omp for schedule(dynamic)
+            for (int i = 0; i < N; ++i) {
+                for (int t = 0; t < interval_ && !finished(i); ++t) {
+                    if (islands_[i].step()) stagnation_[i] = 0;
+                    ++stagnation_[i];
+                }
+            }
+
+            #pragma omp single
+            {
+                migrate_all();
+                done = true;
+                for (int i = 0; i < N; ++i)
+                    if (!finished(i)) done = false;
+            }
+        }
+    }
+}
+
+bool IslandModel::finished(int i) const {
+    return stagnation_[i] >= iterations_ || islands_[i].expired();
+}
+
+void IslandModel::migrate_all() {
+    const int N = islands_.size();
+
+    // Copias de los gbest antes de migrar: todas las islas reciben el
+    // estado del final de la época, sin importar el orden
+    for (int i = 0; i < N; ++i) {
+        outbox_[i].assign(islands_[i].best_set().begin(), islands_[i].best_set().end());
+        outbox_value_[i] = islands_[i].best_value();
+    }
+
+    for (int i = 0; i < N; ++i) {
+        int source = -1;
+        if (topology_ == Topology::Ring) {
+            source = (i + N - 1) % N;
+        } else {
+            for (int j = 0; j < N; ++j)
+                if (j != i && (source < 0 || outbox_value_[j] < outbox_value_[source]))
+                    source = j;
+        }
+
+        if (source < 0 || source == i) continue;
+        if (outbox_value_[source] < islands_[i].best_value() &&
+            islands_[i].migrate(outbox_[source]))
+            stagnation_[i] = 1;
+    }
+}
+
+void IslandModel::sweep() {
+    #pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < (int)islands_.size(); ++i)
+        islands_[i].sweep();
+}
@@ -0,0 +1,99 @@
+#include "../include/lower_bounds.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace {
+
+// Suma en orden creciente de los m menores (reordena xs)
+double sum_smallest(std::vector<double>& xs, int m) {
+    m = std::min<int>(m, xs.size());
+    std::nth_element(xs.begin(), xs.begin() + m, xs.end());
+    std::sort(xs.begin(), xs.begin() + m);
+    double sum = 0.0;
+    for (int i = 0; i < m; ++i) sum += xs[i];
+    return sum;
+}
+
+}
+
+LowerBounds::LowerBounds(const Graph& graph, int k) {
+    const int n = graph.num_vertices();
+    const int need = k - 1;
+    if (need <= 0 || n < 2) return;
+
+    const auto& adj = graph.adjacency();
+    const double INF = std::numeric_limits<double>::infinity();
+
+    // --- Por fila: d1(v) y las need aristas más ligeras hacia j > v ---
+    // Las need más ligeras del grafo están entre las need más ligeras de
+    // alguna fila, así que basta conservar n·need candidatas y no n²/2
+    std::vector<double> d1(n, INF);
+    std::vector<std::vector<double>> lightest(n);
+
+    #pragma omp parallel
+    {
+        std::vector<double> row;
+
+        #pragma omp for schedule(dynamic, 16)
+        for (int v = 0; v < n; ++v) {
+            const double* r = adj[v];
+            double best = INF;
+            for (int j = 0; j < n; ++j)
+                if (j != v && r[j] < best) best = r[j];
+            d1[v] = best;
+
+            row.assign(r + v + 1, r + n);
+            int m = std::min<int>(need, row.size());
+            std::nth_element(row.begin(), row.begin() + m, row.end());
+            lightest[v].assign(row.begin(), row.begin() + m);
+        }
+    }
+
+    std::vector<double> edges;
+    edges.reserve((size_t)n * std::min(need, n));
+    for (const auto& l : lightest)
+        edges.insert(edges.end(), l.begin(), l.end());
+    smallest_edges_ = sum_smallest(edges, need);
+    incident_ = sum_smallest(d1, need);
+
+    // --- Prim denso sobre todo el grafo: pesos de las n - 1 aristas del MST ---
+    std::vector<double> key(n, INF);
+    std::vector<char> in_tree(n, 0);
+    std::vector<double> mst;
+    mst.reserve(n - 1);
+    int u = 0;
+    in_tree[0] = 1;
+    for (int step = 1; step < n; ++step) {
+        const double* r = adj[u];
+        int next = -1;
+        double next_key = INF;
+        for (int j = 0; j < n; ++j) {
+            if (in_tree[j]) continue;
+            if (r[j] < key[j]) key[j] = r[j];
+            if (next == -1 || key[j] < next_key) {
+                next = j;
+                next_key = key[j];
+            }
+        }
+        in_tree[next] = 1;
+        mst.push_back(next_key);
+        u = next;
+    }
+    forest_ = sum_smallest(mst, need);
+}
+
+double LowerBounds::value() const {
+    return std::max({smallest_edges_, forest_, incident_});
+}
+
+double LowerBounds::gap(double value, double bound) {
+    // value bajo la cota solo puede ser redondeo (se tolera) o un valor que no
+    // corresponde a la cota; en ese caso, con value <= 0 y con value = +inf
+    // (desconectado) no hay brecha que reportar: NaN evita que se lea como
+    // óptimo probado
+    if (!std::isfinite(value) || value <= 0.0 || value < bound - 1e-9 * std::fabs(bound))
+        return std::numeric_limits<double>::quiet_NaN();
+    return std::max(0.0, (value - bound) / value);
+}
@@ -1,38 +1,300 @@
 #include "../include/graph_reader.hpp"
-#include "../include/pso.hpp"
+#include "../include/solver.hpp"
 #include "../include/graphy.hpp"
+#include "../include/graph_cache.hpp"
+#include "../include/subset_cache.hpp"
+#include "../include/telemetry.hpp"
+#include "../include/result_writer.hpp"
+#include "../include/server.hpp"
 #include <iostream>
 #include <fstream>
+#include <iomanip>
 #include <cstdlib>
 #include <ctime>
 #include <omp.h>
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <limits>
+#include <cmath>
+#include <memory>
+#include <map>
+#include <mutex>
 
 void print_usage(const char* prog_name) {
     std::cerr << "Uso:\n";
     std::cerr << "  Semilla única:        " << prog_name << " <file> <k> <swarm_size> <seed> [--viz]\n";
     std::cerr << "  Conjunto de semillas: " << prog_name << " <file> <k> <swarm_size> <seed1> <seed2> ... [--viz]\n";
     std::cerr << "  Intervalo de semillas:" << prog_name << " <file> <k> <swarm_size> <seed_inicio>-<seed_fin> [--viz]\n";
+    std::cerr << "  Varios k:             " << prog_name << " <file> <k_inicio>-<k_fin>:<paso> <swarm_size> <seeds> ...\n";
+    std::cerr << "  Construir caché:      " << prog_name << " --build-cache <file>\n";
+    std::cerr << "  Servidor:             " << prog_name << " --serve <socket> [id=]<file> ... [--workers N] [--queue Q]\n"
+              << "                        [--prepared P] [--send-timeout S]\n";
     std::cerr << "\nOpciones:\n";
     std::cerr << "  --viz        Generar visualización SVG de la mejor solución\n";
     std::cerr << "  --viz-tree   Generar visualización como árbol\n";
     std::cerr << "  --viz-circle Generar visualización circular (default)\n";
+    std::cerr << "  --no-cache   Ignorar <file>.kmstbin y leer el archivo de texto\n";
+    std::cerr << "  --threads N  Mover las partículas de cada enjambre en paralelo con N hilos\n";
+    std::cerr << "  --islands T  Modelo de islas: una isla por semilla, topología ring o all\n";
+    std::cerr << "  --migrate-every M  Iteraciones entre migraciones del modelo de islas (default 100)\n";
+    std::cerr << "  --sweep P    Búsqueda local final: first (primer intercambio mejorante, default) o best\n";
+    std::cerr << "  --dlb        Usar don't-look bits en la búsqueda local\n";
+    std::cerr << "  --float32    Buscar con pesos en precisión simple (el resultado se recalcula en double)\n";
+    std::cerr << "  --neighbors M Restringir movimientos y sweep a los M vecinos más cercanos de cada vértice\n";
+    std::cerr << "  --time S     Detener cada corrida tras S segundos (se reporta el mejor hasta entonces)\n";
+    std::cerr << "  --max-evals N Detener cada corrida tras N evaluaciones\n";
+    std::cerr << "  --stagnation N Iteraciones sin mejora antes de detenerse (default 10000)\n";
+    std::cerr << "  --target X   Detener al alcanzar un peso normalizado <= X\n";
+    std::cerr << "  --gap G      Detener todas las semillas con brecha (peso - cota) / peso <= G\n";
+    std::cerr << "  --anytime    Imprimir cada nuevo mejor global con su tiempo\n";
+    std::cerr << "  --output F   Resultados por semilla: files (kmst-<seed>.mst, default), jsonl o csv\n";
+    std::cerr << "  --telemetry  Contadores por rama y reporte JSON en ../kmst-report.json\n";
+    std::cerr << "  --k LISTA    Valores de k (reemplaza <k>): 40, 10,20,40 o 10-200:10\n";
+    std::cerr << "  --cache MB   Memoria de pesos de MST por subconjunto (hash Zobrist) de MB megabytes\n";
+}
+
+// Brecha en porcentaje; NaN (sin cota válida para el valor) se muestra como n/d
+void print_gap(std::ostream& out, double gap) {
+    if (std::isnan(gap)) out << "n/d";
+    else out << 100.0 * gap << "%";
+}
+
+// "40", "10,20,40" o "10-200:10" (paso opcional, default 1); sin repetidos
+std::vector<int> parse_k_list(const std::string& spec) {
+    std::vector<int> ks;
+    size_t start = 0;
+    while (start <= spec.size()) {
+        size_t comma = spec.find(',', start);
+        std::string item = spec.substr(start, comma == std::string::npos ? std::string::npos
+                                                                         : comma - start);
+        size_t dash = item.find('-');
+        if (dash == std::string::npos) {
+            ks.push_back(std::stoi(item));
+        } else {
+            size_t colon = item.find(':', dash);
+            int first = std::stoi(item.substr(0, dash));
+            int last = std::stoi(item.substr(dash + 1, colon == std::string::npos
+                                                        ? std::string::npos : colon - dash - 1));
+            int step = colon == std::string::npos ? 1 : std::stoi(item.substr(colon + 1));
+            if (step < 1)
+                throw std::invalid_argument("Paso de k inválido: " + item);
+            for (int k = first; k <= last; k += step) ks.push_back(k);
+        }
+        if (comma == std::string::npos) break;
+        start = comma + 1;
+    }
+
+    std::vector<int> unique;
+    for (int k : ks)
+        if (std::find(unique.begin(), unique.end(), k) == unique.end())
+            unique.push_back(k);
+    return unique;
+}
+
+/**
+ * Modo de varios k: el grafo base se preprocesa una vez y
+ * Solver::solve_batch reparte los k entre hilos. Cada k se prepara con
+ * Graph::completed(k) al empezar su búsqueda y se libera con su último
+ * resultado, así que solo los k en curso tienen matriz n×n. Cada k escribe
+ * sus resultados con prefijo kmst-k<k> y la curva completa queda en
+ * ../kmst-curve.csv.
+ */
+int run_batch(const Solver& solver, Solver::Request request, const std::vector<int>& ks,
+              ResultWriter::Format format, bool anytime, telemetry::PhaseTimer& phases) {
+    std::cout << "Diámetro: " << solver.graph().diameter() << "\n";
+    std::cout << "Valores de k: " << ks.size() << "\n\n";
+
+    // --- Un escritor por k; los callbacks se enrutan con SeedResult::k ---
+    // Se abre con el primer reporte de k (su grafo ya está preparado dentro
+    // de solve) y se cierra con el último resultado, que libera el grafo
+    struct Output {
+        std::shared_ptr<const Graph> graph;
+        std::unique_ptr<ResultWriter> writer;
+        size_t pending = 0;
+    };
+    std::map<int, Output> outputs;
+    std::mutex outputs_mutex;
+
+    // Con outputs_mutex tomado
+    auto output = [&](int k) -> Output& {
+        Output& o = outputs[k];
+        if (!o.graph) {
+            o.graph = solver.prepare(k);
+            o.writer = std::make_unique<ResultWriter>(*o.graph, format, "..",
+                                                      "kmst-k" + std::to_string(k));
+            o.pending = request.seeds.size();
+        }
+        return o;
+    };
+
+    request.on_result = [&](const Solver::SeedResult& r) {
+        Output finished;
+        {
+            std::lock_guard<std::mutex> lock(outputs_mutex);
+            Output& o = output(r.k);
+            o.writer->submit({r.seed, r.value, r.set, r.parent});
+            if (--o.pending == 0) {
+                finished = std::move(o);
+                outputs.erase(r.k);
+                solver.release(r.k);
+            }
+        }
+        if (finished.writer) finished.writer->close();
+    };
+    if (anytime) {
+        // El tamaño del conjunto es su k
+        request.anytime = [&](unsigned seed, double seconds, double value,
+                              const std::vector<int>& set) {
+            const int k = set.size();
+            double normalizador;
+            {
+                std::lock_guard<std::mutex> lock(outputs_mutex);
+                normalizador = output(k).graph->getNormalizador();
+            }
+            #pragma omp critical(anytime)
+            std::cout << "[anytime] k=" << k << " semilla " << seed << "  t=" << seconds
+                      << "s  peso=" << value / normalizador << std::endl;
+        };
+    }
+
+    phases.start("search");
+    std::vector<Solver::Result> results = solver.solve_batch(request, ks);
+
+    // --- Curva ---
+    phases.start("output");
+    std::cout << "\n=== Mejor resultado por k ===\n";
+    std::ofstream curve("../kmst-curve.csv");
+    curve << std::setprecision(std::numeric_limits<double>::max_digits10);
+    curve << "k,seed,weight,normalized,normalizer,lower_bound,gap\n";
+    for (size_t i = 0; i < ks.size(); ++i) {
+        const Solver::SeedResult& best = results[i].best;
+        std::cout << "k=" << ks[i] << "  seed " << best.seed
+                  << "  peso normalizado " << best.normalized
+                  << "  brecha ";
+        print_gap(std::cout, results[i].gap);
+        std::cout << "\n";
+        curve << ks[i] << ',' << best.seed << ',' << best.value << ','
+              << best.normalized << ',' << results[i].normalizer << ','
+              << results[i].lower_bound << ',' << results[i].gap << "\n";
+    }
+    std::cout << "Curva: kmst-curve.csv\n";
+    phases.stop();
+    return 0;
+}
+
+// Lee el grafo, calcula los caminos mínimos y guarda <file>.kmstbin
+int build_cache(const std::string& input_path) {
+    Graph g = GraphReader::from_file(input_path);
+    g.compute_distances();
+
+    const std::string cache_path = GraphCache::path_for(input_path);
+    GraphCache::write(g, input_path, cache_path);
+    std::cout << "Caché generada: " << cache_path << " (" << g.num_vertices()
+              << " vértices, diámetro " << g.diameter() << ")\n";
+    return 0;
+}
+
+/**
+ * Modo residente: kmst --serve <socket> [id=]<file> ... [--workers N]
+ * [--queue Q] [--prepared P] [--send-timeout S] [--no-cache]. Sin id, el
+ * identificador es el nombre del archivo sin directorio ni extensión.
+ */
+int serve(int argc, char* argv[]) {
+    const std::string socket_path = argv[2];
+    Server::Options options;
+    bool use_cache = true;
+    std::vector<std::pair<std::string, std::string>> graphs;   // (id, archivo)
+
+    for (int i = 3; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc) {
+            options.workers = std::stoi(argv[++i]);
+        } else if (arg == "--queue" && i + 1 < argc) {
+            options.queue = std::stoul(argv[++i]);
+        } else if (arg == "--prepared" && i + 1 < argc) {
+            options.prepared = std::stoul(argv[++i]);
+        } else if (arg == "--send-timeout" && i + 1 < argc) {
+            options.send_timeout = std::stod(argv[++i]);
+        } else if (arg == "--no-cache") {
+            use_cache = false;
+        } else {
+            size_t eq = arg.find('=');
+            std::string path = eq == std::string::npos ? arg : arg.substr(eq + 1);
+            std::string id = arg.substr(0, eq);
+            if (eq == std::string::npos) {
+                size_t slash = path.find_last_of('/');
+                id = path.substr(slash == std::string::npos ? 0 : slash + 1);
+                id = id.substr(0, id.find('.'));
+            }
+            graphs.emplace_back(id, path);
+        }
+    }
+    if (graphs.empty()) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    Server server(socket_path, options);
+    for (const auto& [id, path] : graphs) {
+        std::optional<Graph> cached;
+        if (use_cache)
+            cached = GraphCache::load(path, GraphCache::path_for(path));
+        Graph g = cached ? std::move(*cached) : GraphReader::from_file(path);
+        std::cout << "Grafo " << id << ": " << g.num_vertices() << " vértices"
+                  << (cached ? " (desde caché)\n" : "\n");
+        try {
+            server.add_graph(id, std::move(g));
+        } catch (const std::invalid_argument& e) {
+            std::cerr << "Grafo " << id << ": " << e.what() << "\n";
+            return 1;
+        }
+    }
+
+    std::cout << "Escuchando en " << socket_path << std::endl;
+    server.run();
+    std::cout << "Servidor detenido\n";
+    return 0;
 }
 
 int main(int argc, char* argv[]) {
+    // Semillas (o k) en paralelo y, con --threads, partículas dentro de cada
+    // enjambre: dos niveles de OpenMP, fijados una vez para todo el proceso
+    omp_set_max_active_levels(2);
+
+    if (argc == 3 && std::string(argv[1]) == "--build-cache")
+        return build_cache(argv[2]);
+    if (argc >= 3 && std::string(argv[1]) == "--serve")
+        return serve(argc, argv);
+
     if (argc < 4) {
         print_usage(argv[0]);
         return 1;
     }
 
     const std::string input_path = argv[1];
-    int k = std::atoi(argv[2]);
+    std::vector<int> ks = parse_k_list(argv[2]);
     int swarm_size = std::atoi(argv[3]);
-    const int iterations = 10000;    
+    int iterations = 10000;    
     bool generate_viz = false;
     bool viz_tree = false;
+    bool use_cache = true;
+    int threads = 0;
+    bool use_islands = false;
+    IslandModel::Topology topology = IslandModel::Topology::Ring;
+    int migrate_every = 100;
+    int cache_mb = 0;
+    PSO::SweepPolicy sweep_policy = PSO::SweepPolicy::First;
+    bool dlb = false;
+    bool float32 = false;
+    int neighbors = 0;
+    double seconds = 0.0;
+    long long max_evals = 0;
+    double target = -std::numeric_limits<double>::infinity();
+    double gap = 0.0;
+    bool anytime = false;
+    bool telemetry_on = false;
+    ResultWriter::Format output_format = ResultWriter::Format::Files;
 
     std::vector<unsigned> seeds;
     bool has_seeds = false;
@@ -46,6 +308,43 @@ int main(int argc, char* argv[]) {
         } else if (arg == "--viz-tree") {
             generate_viz = true;
             viz_tree = true;
+        } else if (arg == "--no-cache") {
+            use_cache = false;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = std::stoi(argv[++i]);
+        } else if (arg == "--islands" && i + 1 < argc) {
+            use_islands = true;
+            topology = IslandModel::parse_topology(argv[++i]);
+        } else if (arg == "--migrate-every" && i + 1 < argc) {
+            migrate_every = std::stoi(argv[++i]);
+        } else if (arg == "--sweep" && i + 1 < argc) {
+            sweep_policy = PSO::parse_sweep_policy(argv[++i]);
+        } else if (arg == "--dlb") {
+            dlb = true;
+        } else if (arg == "--float32") {
+            float32 = true;
+        } else if (arg == "--neighbors" && i + 1 < argc) {
+            neighbors = std::stoi(argv[++i]);
+        } else if (arg == "--time" && i + 1 < argc) {
+            seconds = std::stod(argv[++i]);
+        } else if (arg == "--max-evals" && i + 1 < argc) {
+            max_evals = std::stoll(argv[++i]);
+        } else if (arg == "--stagnation" && i + 1 < argc) {
+            iterations = std::stoi(argv[++i]);
+        } else if (arg == "--target" && i + 1 < argc) {
+            target = std::stod(argv[++i]);
+        } else if (arg == "--gap" && i + 1 < argc) {
+            gap = std::stod(argv[++i]);
+        } else if (arg == "--anytime") {
+            anytime = true;
+        } else if (arg == "--output" && i + 1 < argc) {
+            output_format = ResultWriter::parse_format(argv[++i]);
+        } else if (arg == "--telemetry") {
+            telemetry_on = true;
+        } else if (arg == "--k" && i + 1 < argc) {
+            ks = parse_k_list(argv[++i]);
+        } else if (arg == "--cache" && i + 1 < argc) {
+            cache_mb = std::stoi(argv[++i]);
         } else if (arg.find('-') != std::string::npos) {
             size_t dash_pos = arg.find('-');
             unsigned start = std::stoi(arg.substr(0, dash_pos));
@@ -62,78 +361,141 @@ int main(int argc, char* argv[]) {
         seeds.push_back(static_cast<unsigned>(std::time(nullptr)));
     }
 
-    // --- Cargar grafo ---
-    Graph g = GraphReader::from_file(input_path);
-    std::cout << "Grafica cargado con " << g.num_vertices() << " vértices y "
-              << g.num_edges() << " aristas.\n";
+    // stod acepta "nan": se rechaza aquí en lugar de fallar dentro de solve
+    if (!(seconds >= 0.0) || std::isnan(target) || !(gap >= 0.0 && gap < 1.0)) {
+        std::cerr << "--time debe ser >= 0, --target un número y --gap estar en [0, 1)\n";
+        return 1;
+    }
 
-    g.calcula_Normalizador(k);
-    g.complete(k);
-    std::cout << "Normalizador: " << g.getNormalizador() << "\n";
-    std::cout << "Diámetro: " << g.diameter() << "\n\n";
+    telemetry::PhaseTimer phases;
 
-    //std::cout << "Ejecutando " << seeds.size() << " corridas en paralelo...\n";
+    // --- Cargar grafo (desde la caché binaria si está vigente) ---
+    phases.start("load");
+    std::optional<Graph> cached;
+    if (use_cache)
+        cached = GraphCache::load(input_path, GraphCache::path_for(input_path));
 
-    // --- Variables compartidas para mejor global ---
-    double global_best_value = std::numeric_limits<double>::infinity();
-    unsigned global_best_seed = 0;
-    std::vector<int> global_best_set;
-    std::vector<int> global_best_parent;
+    Graph loaded = cached ? std::move(*cached) : GraphReader::from_file(input_path);
+    std::cout << "Grafica cargado con " << loaded.num_vertices() << " vértices y "
+              << loaded.num_edges() << " aristas"
+              << (cached ? " (desde caché).\n" : ".\n");
 
-    #pragma omp parallel for schedule(dynamic)
-    for (size_t i = 0; i < seeds.size(); ++i) {
-        unsigned seed = seeds[i];
-        //int thread_id = omp_get_thread_num();
+    for (int k : ks) {
+        if (k < 1 || k > loaded.num_vertices()) {
+            std::cerr << "k fuera de rango: " << k << " (la gráfica tiene "
+                      << loaded.num_vertices() << " vértices)\n";
+            return 1;
+        }
+    }
 
-        //#pragma omp critical
-        //std::cout << "[Hilo " << thread_id << "] ejecutando semilla " << seed << "\n";
+    // Con un solo k el grafo se completa en su lugar: una sola matriz n×n
+    phases.start("shortest_paths");
+    std::unique_ptr<Solver> solver_ptr;
+    try {
+        solver_ptr = std::make_unique<Solver>(std::move(loaded), ks.size() == 1 ? ks[0] : 0);
+    } catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << "\n";
+        return 1;
+    }
+    const Solver& solver = *solver_ptr;
 
-        PSO solver(g, k, swarm_size, iterations, 0.6, 0.3, seed);
-        solver.initialize();
-        solver.run();
-        solver.sweep();
+    // --- Solicitud (común a todos los k) ---
+    Solver::Request request;
+    request.swarm_size = swarm_size;
+    request.stagnation = iterations;
+    request.seeds = seeds;
+    request.seconds = seconds;
+    request.evaluations = max_evals;
+    request.target = target;
+    request.gap = gap;
+    request.threads = threads;
+    request.islands = use_islands;
+    request.topology = topology;
+    request.migrate_every = migrate_every;
+    request.sweep = sweep_policy;
+    request.dlb = dlb;
+    request.single_precision = float32;
+    request.neighbors = neighbors;
+    request.telemetry = telemetry_on;
 
-        double best_val = solver.best_value();
-        std::vector<int> best_set = solver.best_set();
+    // La caché de subconjuntos se comparte: los conjuntos de distinto k nunca coinciden
+    std::unique_ptr<SubsetCache> subset_cache;
+    if (cache_mb > 0)
+        subset_cache = std::make_unique<SubsetCache>(solver.graph().num_vertices(), cache_mb);
+    request.cache = subset_cache.get();
 
-        // Normalizar antes de guardar
-        double normalized_val = best_val / g.getNormalizador();
+    if (ks.size() > 1) {
+        if (generate_viz || telemetry_on)
+            std::cerr << "[WARN] --viz y --telemetry se ignoran con varios k\n";
+        request.telemetry = false;
+        return run_batch(solver, request, ks, output_format, anytime, phases);
+    }
 
-        // Calcular árbol MST para esta solución
-        auto [parent, mst_weight] = g.prim_subset_full(best_set);
+    const int k = ks[0];
+    request.k = k;
 
-        // Guardar resultado en archivo
-        std::ofstream out("../kmst-" + std::to_string(seed) + ".mst");
-        out << "# Resultados PSO - Semilla " << seed << "\n";
-        out << "# Mejor conjunto (gbest): ";
-        for (int v : best_set) out << g.get_vertex_name(v) << " ";
-        out << "\n# Peso total normalizado: " << normalized_val << "\n";
-        out << "# Aristas del MST:\n";
-        out << g.mst_to_string(best_set, parent);
-        out.close();
+    phases.start("prepare");
+    std::shared_ptr<const Graph> prepared = solver.prepare(k);
+    const Graph& g = *prepared;
+    std::cout << "Normalizador: " << g.getNormalizador() << "\n";
+    std::cout << "Diámetro: " << g.diameter() << "\n\n";
 
-        #pragma omp critical
-        {
-            //std::cout << "[Seed " << seed << "] terminado. Peso = "
-            //          << normalized_val << " → guardado en kmst-" << seed << ".mst\n";
-            
-            if (best_val < global_best_value) {
-                global_best_value = best_val;
-                global_best_seed = seed;
-                global_best_set = best_set;
-                global_best_parent = parent;
-            }
-        }
+    // --- Listas de vecinos cercanos (sobre la matriz completada) ---
+    phases.start("setup");
+    if (neighbors > 0)
+        solver.candidate_lists(k, neighbors);
+
+    std::shared_ptr<const LowerBounds> bounds = solver.lower_bounds(k);
+    const double norm = g.getNormalizador();
+    std::cout << "Cota inferior normalizada: " << bounds->value() / norm
+              << " (aristas " << bounds->smallest_edges() / norm
+              << ", bosque " << bounds->forest() / norm
+              << ", incidentes " << bounds->incident() / norm << ")\n";
+
+    if (anytime) {
+        const double normalizador = g.getNormalizador();
+        request.anytime = [normalizador](unsigned seed, double seconds, double value,
+                                         const std::vector<int>&) {
+            #pragma omp critical(anytime)
+            std::cout << "[anytime] semilla " << seed << "  t=" << seconds
+                      << "s  peso=" << value / normalizador << std::endl;
+        };
     }
 
+    // --- Búsqueda; cada semilla se encola en el escritor al terminar ---
+    phases.start("search");
+    ResultWriter writer(g, output_format, "..");
+    request.on_result = [&writer](const Solver::SeedResult& r) {
+        writer.submit({r.seed, r.value, r.set, r.parent});
+    };
+    Solver::Result result = solver.solve(request);
+    const Solver::SeedResult& global_best = result.best;
+
+    writer.close();
+    phases.start("output");
+
     // --- Mostrar mejor global ---
     std::cout << "\n=== Mejor resultado global ===\n";
-    std::cout << "Seed: " << global_best_seed << "\n";
+    std::cout << "Seed: " << global_best.seed << "\n";
     std::cout << "Conjunto: { ";
-    for (int v : global_best_set) std::cout << g.get_vertex_name(v) << " ";
+    for (int v : global_best.set) std::cout << g.get_vertex_name(v) << " ";
     std::cout << "}\n";
-    std::cout << "Peso total normalizado: " 
-              << global_best_value / g.getNormalizador() << "\n";
+    std::cout << "Peso total normalizado: " << global_best.normalized << "\n";
+    std::cout << "Brecha respecto a la cota: ";
+    print_gap(std::cout, result.gap);
+    std::cout << "\n";
+
+    if (subset_cache) {
+        // Cada semilla cuenta sus consultas; se suman aquí
+        std::uint64_t hits = 0, misses = 0;
+        for (const Solver::SeedResult& r : result.runs) {
+            hits += r.stats.counters.cache_hits;
+            misses += r.stats.counters.cache_misses;
+        }
+        std::uint64_t total = hits + misses;
+        std::cout << "Caché de subconjuntos: " << hits << " aciertos, " << misses
+                  << " fallos (" << (total ? 100.0 * hits / total : 0.0) << "%)\n";
+    }
  
 
     // --- Generar visualización si se solicitó ---
@@ -141,11 +503,11 @@ int main(int argc, char* argv[]) {
         Graphy viz(g);
         
         if (viz_tree) {
-            viz.dibujaArbol(global_best_set, global_best_parent, 
+            viz.dibujaArbol(global_best.set, global_best.parent, 
                            "../kmst-best-tree.svg");
             std::cout << "\n✓ Visualización de árbol generada: kmst-best-tree.svg\n";
         } else {
-            viz.dibujaCircular(global_best_set, global_best_parent,
+            viz.dibujaCircular(global_best.set, global_best.parent,
                               "../kmst-best-circle.svg");
             std::cout << "\n✓ Visualización circular generada: kmst-best-circle.svg\n";
         }
@@ -153,5 +515,18 @@ int main(int argc, char* argv[]) {
         std::cout << "  Abre el archivo .svg en tu navegador para ver la solución.\n";
     }
 
+    phases.stop();
+
+    // --- Reporte de telemetría (junto a los .mst) ---
+    if (telemetry_on) {
+        telemetry::RunInfo info{input_path, k, swarm_size, omp_get_max_threads(), use_islands};
+        std::vector<telemetry::SeedReport> seed_reports;
+        for (const Solver::SeedResult& r : result.runs)
+            seed_reports.push_back({r.seed, r.thread, r.value, r.normalized, r.stats});
+        std::ofstream out("../kmst-report.json");
+        telemetry::write_report(out, info, phases, seed_reports, subset_cache.get());
+        std::cout << "Reporte de telemetría: kmst-report.json\n";
+    }
+
     return 0;
 }
@@ -0,0 +1,382 @@
+#include "../include/prim_kernel.hpp"
+#include <limits>
+#include <string>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define PRIM_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+namespace prim_kernel {
+
+namespace {
+
+// --- Escalar ---
+// Dos pasadas: la primera (relajación + mínimo) se vectoriza como reducción;
+// la segunda solo localiza el primer índice con ese valor.
+template <bool Parent, typename T>
+int relax_scalar(const T* row, const int* ids, T* key,
+                 int* par, int u, int r) {
+    T best = std::numeric_limits<T>::infinity();
+
+    #pragma omp simd reduction(min:best)
+    for (int t = 0; t < r; ++t) {
+        T w = row[ids[t]];
+        T kt = key[t];
+        bool better = w < kt;
+        key[t] = better ? w : kt;
+        if constexpr (Parent)
+            par[t] = better ? u : par[t];
+        kt = key[t];
+        best = (kt < best) ? kt : best;
+    }
+
+    int j = 0;
+    while (j < r - 1 && !(key[j] == best))
+        ++j;
+    return j;
+}
+
+#ifdef PRIM_KERNEL_X86
+
+// --- AVX2 (4 dobles por vector) ---
+// Una sola pasada: cada carril guarda su menor key y el primer índice donde
+// aparece (solo se reemplaza con "<" estricto); al final se reducen los
+// carriles desempatando por índice, igual que la versión escalar.
+template <bool Parent>
+__attribute__((target("avx2")))
+int relax_avx2(const double* row, const int* ids, double* key,
+               int* par, int u, int r) {
+    const __m256d inf = _mm256_set1_pd(std::numeric_limits<double>::infinity());
+    const __m256i pack = _mm256_setr_epi32(0, 2, 4, 6, 0, 0, 0, 0);
+    const __m128i uvec = _mm_set1_epi32(u);
+    const __m256d all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+
+    __m256d best = inf;
+    __m256d best_idx = _mm256_setzero_pd();
+    __m256d idx = _mm256_setr_pd(0.0, 1.0, 2.0, 3.0);
+    const __m256d step = _mm256_set1_pd(4.0);
+
+    int t = 0;
+    for (; t + 4 <= r; t += 4) {
+        __m128i vi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ids + t));
+        // Gather con máscara completa y origen cero (la forma sin máscara
+        // deja el origen indefinido y GCC lo reporta como no inicializado)
+        __m256d w = _mm256_mask_i32gather_pd(_mm256_setzero_pd(), row, vi, all, 8);
+        __m256d kt = _mm256_loadu_pd(key + t);
+
+        __m256d better = _mm256_cmp_pd(w, kt, _CMP_LT_OQ);
+        kt = _mm256_blendv_pd(kt, w, better);
+        _mm256_storeu_pd(key + t, kt);
+
+        if constexpr (Parent) {
+            __m256i m64 = _mm256_castpd_si256(better);
+            __m128i m32 = _mm256_castsi256_si128(_mm256_permutevar8x32_epi32(m64, pack));
+            _mm_maskstore_epi32(par + t, m32, uvec);
+        }
+
+        __m256d lower = _mm256_cmp_pd(kt, best, _CMP_LT_OQ);
+        best = _mm256_blendv_pd(best, kt, lower);
+        best_idx = _mm256_blendv_pd(best_idx, idx, lower);
+        idx = _mm256_add_pd(idx, step);
+    }
+
+    alignas(32) double bv[4], bi[4];
+    _mm256_store_pd(bv, best);
+    _mm256_store_pd(bi, best_idx);
+
+    double b = bv[0];
+    int j = static_cast<int>(bi[0]);
+    for (int l = 1; l < 4; ++l) {
+        int jl = static_cast<int>(bi[l]);
+        if (bv[l] < b || (bv[l] == b && jl < j)) {
+            b = bv[l];
+            j = jl;
+        }
+    }
+
+    // Cola escalar: sus índices son mayores, basta "<" estricto
+    for (; t < r; ++t) {
+        double w = row[ids[t]];
+        if (w < key[t]) {
+            key[t] = w;
+            if constexpr (Parent) par[t] = u;
+        }
+        if (key[t] < b) {
+            b = key[t];
+            j = t;
+        }
+    }
+    return j;
+}
+
+// --- AVX-512 (8 dobles por vector, registros de máscara) ---
+template <bool Parent>
+__attribute__((target("avx512f,avx512vl")))
+int relax_avx512(const double* row, const int* ids, double* key,
+                 int* par, int u, int r) {
+    const __m256i uvec = _mm256_set1_epi32(u);
+
+    __m512d best = _mm512_set1_pd(std::numeric_limits<double>::infinity());
+    __m512d best_idx = _mm512_setzero_pd();
+    __m512d idx = _mm512_setr_pd(0.0, 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0);
+    const __m512d step = _mm512_set1_pd(8.0);
+
+    int t = 0;
+    for (; t + 8 <= r; t += 8) {
+        __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids + t));
+        __m512d w = _mm512_mask_i32gather_pd(_mm512_setzero_pd(), 0xFF, vi, row, 8);
+        __m512d kt = _mm512_loadu_pd(key + t);
+
+        __mmask8 better = _mm512_cmp_pd_mask(w, kt, _CMP_LT_OQ);
+        kt = _mm512_mask_mov_pd(kt, better, w);
+        _mm512_storeu_pd(key + t, kt);
+
+        if constexpr (Parent)
+            _mm256_mask_storeu_epi32(par + t, better, uvec);
+
+        __mmask8 lower = _mm512_cmp_pd_mask(kt, best, _CMP_LT_OQ);
+        best = _mm512_mask_mov_pd(best, lower, kt);
+        best_idx = _mm512_mask_mov_pd(best_idx, lower, idx);
+        idx = _mm512_add_pd(idx, step);
+    }
+
+    alignas(64) double bv[8], bi[8];
+    _mm512_store_pd(bv, best);
+    _mm512_store_pd(bi, best_idx);
+
+    double b = bv[0];
+    int j = static_cast<int>(bi[0]);
+    for (int l = 1; l < 8; ++l) {
+        int jl = static_cast<int>(bi[l]);
+        if (bv[l] < b || (bv[l] == b && jl < j)) {
+            b = bv[l];
+            j = jl;
+        }
+    }
+
+    for (; t < r; ++t) {
+        double w = row[ids[t]];
+        if (w < key[t]) {
+            key[t] = w;
+            if constexpr (Parent) par[t] = u;
+        }
+        if (key[t] < b) {
+            b = key[t];
+            j = t;
+        }
+    }
+    return j;
+}
+
+// --- AVX2 en precisión simple (8 floats por vector) ---
+// Mismo esquema que relax_avx2; la máscara de 32 bits ya tiene el ancho
+// de par, así que se guarda sin reacomodar. Los índices por carril van en
+// float: exactos mientras r < 2^24.
+template <bool Parent>
+__attribute__((target("avx2")))
+int relax_avx2_f32(const float* row, const int* ids, float* key,
+                   int* par, int u, int r) {
+    const __m256 inf = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+    const __m256i uvec = _mm256_set1_epi32(u);
+    const __m256 all = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+    __m256 best = inf;
+    __m256 best_idx = _mm256_setzero_ps();
+    __m256 idx = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+    const __m256 step = _mm256_set1_ps(8.0f);
+
+    int t = 0;
+    for (; t + 8 <= r; t += 8) {
+        __m256i vi = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids + t));
+        __m256 w = _mm256_mask_i32gather_ps(_mm256_setzero_ps(), row, vi, all, 4);
+        __m256 kt = _mm256_loadu_ps(key + t);
+
+        __m256 better = _mm256_cmp_ps(w, kt, _CMP_LT_OQ);
+        kt = _mm256_blendv_ps(kt, w, better);
+        _mm256_storeu_ps(key + t, kt);
+
+        if constexpr (Parent)
+            _mm256_maskstore_epi32(par + t, _mm256_castps_si256(better), uvec);
+
+        __m256 lower = _mm256_cmp_ps(kt, best, _CMP_LT_OQ);
+        best = _mm256_blendv_ps(best, kt, lower);
+        best_idx = _mm256_blendv_ps(best_idx, idx, lower);
+        idx = _mm256_add_ps(idx, step);
+    }
+
+    alignas(32) float bv[8], bi[8];
+    _mm256_store_ps(bv, best);
+    _mm256_store_ps(bi, best_idx);
+
+    float b = bv[0];
+    int j = static_cast<int>(bi[0]);
+    for (int l = 1; l < 8; ++l) {
+        int jl = static_cast<int>(bi[l]);
+        if (bv[l] < b || (bv[l] == b && jl < j)) {
+            b = bv[l];
+            j = jl;
+        }
+    }
+
+    for (; t < r; ++t) {
+        float w = row[ids[t]];
+        if (w < key[t]) {
+            key[t] = w;
+            if constexpr (Parent) par[t] = u;
+        }
+        if (key[t] < b) {
+            b = key[t];
+            j = t;
+        }
+    }
+    return j;
+}
+
+// --- AVX-512 en precisión simple (16 floats por vector) ---
+template <bool Parent>
+__attribute__((target("avx512f")))
+int relax_avx512_f32(const float* row, const int* ids, float* key,
+                     int* par, int u, int r) {
+    const __m512i uvec = _mm512_set1_epi32(u);
+
+    __m512 best = _mm512_set1_ps(std::numeric_limits<float>::infinity());
+    __m512 best_idx = _mm512_setzero_ps();
+    __m512 idx = _mm512_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f,
+                                8.0f, 9.0f, 10.0f, 11.0f, 12.0f, 13.0f, 14.0f, 15.0f);
+    const __m512 step = _mm512_set1_ps(16.0f);
+
+    int t = 0;
+    for (; t + 16 <= r; t += 16) {
+        __m512i vi = _mm512_loadu_si512(ids + t);
+        __m512 w = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, vi, row, 4);
+        __m512 kt = _mm512_loadu_ps(key + t);
+
+        __mmask16 better = _mm512_cmp_ps_mask(w, kt, _CMP_LT_OQ);
+        kt = _mm512_mask_mov_ps(kt, better, w);
+        _mm512_storeu_ps(key + t, kt);
+
+        if constexpr (Parent)
+            _mm512_mask_storeu_epi32(par + t, better, uvec);
+
+        __mmask16 lower = _mm512_cmp_ps_mask(kt, best, _CMP_LT_OQ);
+        best = _mm512_mask_mov_ps(best, lower, kt);
+        best_idx = _mm512_mask_mov_ps(best_idx, lower, idx);
+        idx = _mm512_add_ps(idx, step);
+    }
+
+    alignas(64) float bv[16], bi[16];
+    _mm512_store_ps(bv, best);
+    _mm512_store_ps(bi, best_idx);
+
+    float b = bv[0];
+    int j = static_cast<int>(bi[0]);
+    for (int l = 1; l < 16; ++l) {
+        int jl = static_cast<int>(bi[l]);
+        if (bv[l] < b || (bv[l] == b && jl < j)) {
+            b = bv[l];
+            j = jl;
+        }
+    }
+
+    for (; t < r; ++t) {
+        float w = row[ids[t]];
+        if (w < key[t]) {
+            key[t] = w;
+            if constexpr (Parent) par[t] = u;
+        }
+        if (key[t] < b) {
+            b = key[t];
+            j = t;
+        }
+    }
+    return j;
+}
+
+#endif
+
+// --- Despacho ---
+// Se elige una sola vez, la primera vez que se usa el núcleo (set_isa puede
+// reemplazarlo después)
+
+using Kernel = int (*)(const double*, const int*, double*, int*, int, int);
+using Kernel32 = int (*)(const float*, const int*, float*, int*, int, int);
+
+struct Dispatch {
+    Kernel plain;
+    Kernel parent;
+    Kernel32 plain32;
+    Kernel32 parent32;
+    const char* name;
+};
+
+// Núcleos de la implementación pedida; false si el CPU no la soporta
+bool make(const std::string& name, Dispatch& out) {
+    if (name == "scalar") {
+        out = {relax_scalar<false, double>, relax_scalar<true, double>,
+               relax_scalar<false, float>, relax_scalar<true, float>, "scalar"};
+        return true;
+    }
+#ifdef PRIM_KERNEL_X86
+    __builtin_cpu_init();
+    if (name == "avx512" && __builtin_cpu_supports("avx512f") &&
+        __builtin_cpu_supports("avx512vl")) {
+        out = {relax_avx512<false>, relax_avx512<true>,
+               relax_avx512_f32<false>, relax_avx512_f32<true>, "avx512"};
+        return true;
+    }
+    if (name == "avx2" && __builtin_cpu_supports("avx2")) {
+        out = {relax_avx2<false>, relax_avx2<true>,
+               relax_avx2_f32<false>, relax_avx2_f32<true>, "avx2"};
+        return true;
+    }
+#endif
+    return false;
+}
+
+Dispatch select() {
+    Dispatch d{};
+    for (const char* name : {"avx512", "avx2"})
+        if (make(name, d)) return d;
+    make("scalar", d);
+    return d;
+}
+
+Dispatch& dispatch() {
+    static Dispatch d = select();
+    return d;
+}
+
+}
+
+int relax_argmin(const double* row, const int* ids, double* key, int r) {
+    return dispatch().plain(row, ids, key, nullptr, 0, r);
+}
+
+int relax_argmin_parent(const double* row, const int* ids, double* key,
+                        int* par, int u, int r) {
+    return dispatch().parent(row, ids, key, par, u, r);
+}
+
+int relax_argmin(const float* row, const int* ids, float* key, int r) {
+    return dispatch().plain32(row, ids, key, nullptr, 0, r);
+}
+
+int relax_argmin_parent(const float* row, const int* ids, float* key,
+                        int* par, int u, int r) {
+    return dispatch().parent32(row, ids, key, par, u, r);
+}
+
+const char* isa() {
+    return dispatch().name;
+}
+
+bool set_isa(const std::string& name) {
+    Dispatch d{};
+    if (name == "auto") d = select();
+    else if (!make(name, d)) return false;
+    dispatch() = d;
+    return true;
+}
+
+}
@@ -3,6 +3,11 @@
 #include <unordered_set>
 #include <algorithm>
 #include <iostream>
+#include <atomic>
+#include <stdexcept>
+#include <omp.h>
+#include <chrono>
+#include <cmath>
 
 PSO::PSO(const Graph& graph, int k, int swarm_size, int iterations,
          double alpha_g, double alpha_p, unsigned seed)
@@ -14,131 +19,344 @@ PSO::PSO(const Graph& graph, int k, int swarm_size, int iterations,
       alpha_g_(alpha_g),
       alpha_p_(alpha_p),
       swarm_(swarm_size),
-      rng_(seed),
-      dist01_(0.0, 1.0)
+      seed_(seed),
+      threads_(0),
+      cache_(nullptr),
+      sweep_policy_(SweepPolicy::First),
+      dlb_(false),
+      candidates_(nullptr),
+      single_(nullptr),
+      evaluations_(0),
+      telemetry_(false),
+      gbest_improvements_(0),
+      sweep_moves_(0),
+      search_seconds_(0.0),
+      sweep_seconds_(0.0),
+      rng_(seed, SWARM_STREAM)
 {
     swarm_.particles.reserve(swarm_size);
     swarm_.gbest.reserve(k);
 }
 
 void PSO::initialize() {
-    std::uniform_int_distribution<int> dist_vertex(0, n_ - 1);
-    double best_global_value = std::numeric_limits<double>::infinity();
-    std::vector<int> best_global_set;
-    best_global_set.reserve(k_);
-
-    for (auto& p : swarm_.particles) {
-        std::unordered_set<int> used;
-        used.reserve(k_);
+    const int P = swarm_.particles.size();
+    start_ = std::chrono::steady_clock::now();
+    evaluations_ = 0;
+    gbest_improvements_ = 0;
+    sweep_moves_ = 0;
+    sweep_counters_ = telemetry::Counters{};
+
+    // Cada partícula tiene su propio flujo Philox con clave (seed, índice):
+    // cada número es función de (seed, partícula, paso, extracción), así que
+    // el resultado no depende del número de hilos ni del orden de ejecución
+    #pragma omp parallel for schedule(static) num_threads(std::max(1, threads_)) if(threads_ > 1)
+    for (int i = 0; i < P; ++i) {
+        Particle& p = swarm_.particles[i];
+        p.rng = Philox(seed_, static_cast<std::uint32_t>(i));
+        p.rng.seek(0);
+        p.step = 0;
+
+        // Todos los buffers de la partícula se reservan aquí; los movimientos
+        // posteriores ya no reservan memoria
+        p.members.resize(n_);
+        p.candidates.clear();
+        p.candidates.reserve(std::max(k_, 10));
         p.current.clear();
         p.current.reserve(k_);
-        
+
+        // Paso 0: los enteros se generan por lotes (Philox::generate) y se
+        // escalan a [0, n) por multiplicación; el sesgo, < n / 2^32, no
+        // importa para el punto de partida
+        std::vector<std::uint32_t> draws(2 * k_);
+        size_t next = draws.size();
         while ((int)p.current.size() < k_) {
-            int v = dist_vertex(rng_);
-            if (used.insert(v).second)
+            if (next == draws.size()) {
+                p.rng.generate(draws.data(), draws.size());
+                next = 0;
+            }
+            int v = static_cast<int>((std::uint64_t(draws[next++]) * n_) >> 32);
+            if (!p.members.test(v)) {
+                p.members.set(v);
                 p.current.push_back(v);
+            }
         }
 
-        double cost = graph_.prim_subset(p.current);
+        p.tree = IncrementalMST(graph_, single_);
+        double cost = p.tree.build(p.current);
         
         p.best = p.current;
         p.best.reserve(k_);
         p.best_value = cost;
         p.current_value = cost;
-        if (cost < best_global_value) {
-            best_global_value = cost;
-            best_global_set = p.current;
-        } 
+        p.stale = false;
+        p.stats = telemetry::Counters{};
+
+        if (cache_) {
+            p.hash = cache_->hash(p.current);
+            cache_->store(p.hash, cost);
+        }
     }
 
-    swarm_.gbest = best_global_set;
-    swarm_.gbest_value = best_global_value;
+    // gbest parte de la primera partícula aunque su peso sea +inf (subconjunto
+    // desconectado): nunca queda vacío
+    swarm_.gbest.clear();
+    swarm_.gbest_value = std::numeric_limits<double>::infinity();
+    for (const auto& p : swarm_.particles) {
+        if (swarm_.gbest.empty() || p.best_value < swarm_.gbest_value) {
+            swarm_.gbest_value = p.best_value;
+            swarm_.gbest = p.best;
+        }
+    }
+    evaluations_ += P;
+    notify(swarm_.gbest, swarm_.gbest_value);
 }
 
-std::vector<int> PSO::transition(const Particle& p) const {
-    thread_local std::unordered_set<int> current_set;
-    thread_local std::vector<int> candidates;
-    
-    current_set.clear();
-    current_set.insert(p.current.begin(), p.current.end());
-    
+PSO::Move PSO::transition(Particle& p) const {
+    std::vector<int>& candidates = p.candidates;
     candidates.clear();
     
-    double rand = dist01_(rng_);
+    // Un paso de Philox por movimiento: las extracciones de este movimiento
+    // dependen solo de (seed, partícula, p.step)
+    p.rng.seek(++p.step);
+    double rand = p.rng.uniform01();
+    int branch;
     if (rand < alpha_g_) {
+        branch = telemetry::GBEST;
         for (int v : swarm_.gbest) {
-            if (!current_set.count(v)) {
+            if (!p.members.test(v)) {
                 candidates.push_back(v);
             }
         }
     } 
     else if (rand < alpha_g_ + alpha_p_) {
+        branch = telemetry::PBEST;
         for (int v : p.best) {
-            if (!current_set.count(v)) {
+            if (!p.members.test(v)) {
                 candidates.push_back(v);
             }
         }
     } 
     else {
+        branch = telemetry::RANDOM;
 
-        candidates.reserve(std::min(10, n_ - k_));
-        std::uniform_int_distribution<int> dist(0, n_ - 1);
-        
+        // Con listas de candidatos: un vecino cercano de un miembro al azar
         int attempts = 0;
         const int max_attempts = std::min(20, n_);
         
+        // Los candidatos se marcan en members mientras se muestrea para
+        // descartar repetidos; al final se desmarcan
         while ((int)candidates.size() < 10 && attempts < max_attempts) {
-            int v = dist(rng_);
-            if (!current_set.count(v) && 
-                std::find(candidates.begin(), candidates.end(), v) == candidates.end()) {
+            int v;
+            if (candidates_) {
+                int member = p.current[p.rng.below(k_)];
+                v = candidates_->of(member)[p.rng.below(candidates_->size())];
+            } else {
+                v = p.rng.below(n_);
+            }
+            if (!p.members.test(v)) {
+                p.members.set(v);
                 candidates.push_back(v);
             }
             attempts++;
         }
+        for (int v : candidates)
+            p.members.reset(v);
     }
     
     if (candidates.empty())
-        return p.current;
-    
-    std::vector<int> new_current = p.current;
+        return {-1, -1, branch};
    
-    std::uniform_int_distribution<int> dist_cand(0, candidates.size() - 1);
-    std::uniform_int_distribution<int> dist_pos(0, new_current.size() - 1);
+    int v = candidates[p.rng.below(candidates.size())];
+    int pos = p.rng.below(p.current.size());
     
-    new_current[dist_pos(rng_)] = candidates[dist_cand(rng_)];
-    
-    return new_current;
+    return {pos, v, branch};
+}
+
+void PSO::apply_move(Particle& p, Move mv) const {
+    const int old = p.current[mv.pos];
+    p.current[mv.pos] = mv.vertex;
+    p.members.reset(old);
+    p.members.set(mv.vertex);
+    if (cache_)
+        p.hash ^= cache_->token(old) ^ cache_->token(mv.vertex);
+}
+
+void PSO::move_particle(Particle& p) {
+    const double before = p.current_value;
+    Move mv = transition(p);
+    if (mv.pos >= 0) {
+        apply_move(p, mv);
+
+        if (!cache_) {
+            p.current_value = p.tree.commit_swap(mv.pos, mv.vertex);
+        } else {
+            double cached;
+            if (cache_->lookup(p.hash, cached)) {
+                ++p.stats.cache_hits;
+                p.current_value = cached;
+                p.stale = true;
+            } else {
+                ++p.stats.cache_misses;
+                p.current_value = p.stale ? p.tree.build(p.current)
+                                          : p.tree.commit_swap(mv.pos, mv.vertex);
+                p.stale = false;
+                cache_->store(p.hash, p.current_value);
+            }
+        }
+    }
+
+    const bool new_pbest = p.current_value < p.best_value;
+    if (new_pbest) {
+        p.best = p.current;
+        p.best_value = p.current_value;
+    }
+
+    if (telemetry_) {
+        telemetry::Counters& c = p.stats;
+        ++c.proposals[mv.branch];
+        if (mv.pos < 0) ++c.no_candidates[mv.branch];
+        else if (p.current_value < before) ++c.accepted[mv.branch];
+        if (new_pbest) ++c.pbest_updates[mv.branch];
+    }
+}
+
+double PSO::elapsed() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start_).count();
+}
+
+bool PSO::reached(double value) const {
+    if (value > limits_.target) return false;
+    if (limits_.stop) limits_.stop->store(true, std::memory_order_relaxed);
+    return true;
+}
+
+bool PSO::expired() const {
+    if (reached(swarm_.gbest_value)) return true;
+    if (limits_.stop && limits_.stop->load(std::memory_order_relaxed)) return true;
+    if (limits_.evaluations > 0 && evaluations_ >= limits_.evaluations) return true;
+    return limits_.seconds > 0.0 && elapsed() >= limits_.seconds;
+}
+
+telemetry::SearchStats PSO::stats() const {
+    telemetry::SearchStats s;
+    for (const auto& p : swarm_.particles)
+        s.counters += p.stats;
+    s.counters += sweep_counters_;
+    s.evaluations = evaluations_;
+    s.gbest_improvements = gbest_improvements_;
+    s.sweep_moves = sweep_moves_;
+    s.search_seconds = search_seconds_;
+    s.sweep_seconds = sweep_seconds_;
+    return s;
+}
+
+void PSO::notify(const std::vector<int>& set, double value) const {
+    if (anytime_)
+        anytime_(seed_, elapsed(), value, set);
+}
+
+bool PSO::update_gbest() {
+    // Reducción en orden de índice: el resultado no depende de cuántos hilos
+    // hay ni de cómo se repartió el trabajo
+    int best = -1;
+    double best_value = swarm_.gbest_value;
+    for (int i = 0; i < (int)swarm_.particles.size(); ++i) {
+        if (swarm_.particles[i].best_value < best_value) {
+            best_value = swarm_.particles[i].best_value;
+            best = i;
+        }
+    }
+
+    if (best < 0) return false;
+    swarm_.gbest = swarm_.particles[best].best;
+    swarm_.gbest_value = best_value;
+    ++gbest_improvements_;
+    notify(swarm_.gbest, swarm_.gbest_value);
+    return true;
+}
+
+bool PSO::step() {
+    const int P = swarm_.particles.size();
+    evaluations_ += P;
+
+    // gbest no cambia durante este ciclo con o sin hilos: todas las
+    // partículas ven el mejor global de la iteración anterior
+    if (threads_ > 0) {
+        #pragma omp parallel for schedule(static) num_threads(threads_)
+        for (int i = 0; i < P; ++i)
+            move_particle(swarm_.particles[i]);
+    } else {
+        for (auto& p : swarm_.particles)
+            move_particle(p);
+    }
+    return update_gbest();
 }
 
 void PSO::run() {
-    //int stagnation = 0;
-    //const int MAX_STAGNATION = 5000;  
-    for (int iter = 0; iter < iterations_; ++iter) {
-        //bool improved = false;
-
-        for (auto& p : swarm_.particles) {
-            std::vector<int> new_pos = transition(p);
-            double new_value = graph_.prim_subset(new_pos);
-
-            p.current = std::move(new_pos);  
-            p.current_value = new_value;
-
-            if (new_value < p.best_value) {
-                p.best = p.current;
-                p.best_value = new_value;
-                
-                if (new_value < swarm_.gbest_value) {
-                    swarm_.gbest = p.current;
-                    swarm_.gbest_value = new_value;
-                    //improved = true;
-                    //stagnation = 0;  
-                    iter = 0;      
-                }
-            }   
+    if (threads_ > 0) {
+        run_synchronous();
+        return;
+    }
+
+    int iter = 0;
+    while (iter < iterations_ && !expired()) {
+        if (step()) iter = 0;
+        ++iter;
+    }
+}
+
+void PSO::run_synchronous() {
+    const int P = swarm_.particles.size();
+    int iter = 0;
+
+    // Una sola región paralela para toda la corrida (step() abre una por iteración)
+    #pragma omp parallel num_threads(threads_)
+    {
+        while (iter < iterations_) {
+            // gbest no cambia durante este ciclo: todas las partículas ven
+            // el mejor global de la iteración anterior
+            #pragma omp for schedule(static)
+            for (int i = 0; i < P; ++i)
+                move_particle(swarm_.particles[i]);
+
+            #pragma omp single
+            {
+                evaluations_ += P;
+                if (update_gbest()) iter = 0;
+                ++iter;
+                if (expired()) iter = iterations_;
+            }
         }
+    }
+}
+
+bool PSO::migrate(const std::vector<int>& set) {
+    Particle* worst = &swarm_.particles[0];
+    for (auto& p : swarm_.particles)
+        if (p.current_value > worst->current_value)
+            worst = &p;
 
+    // assign reutiliza la capacidad reservada: no hay reservas de memoria
+    for (int v : worst->current) worst->members.reset(v);
+    worst->current.assign(set.begin(), set.end());
+    for (int v : worst->current) worst->members.set(v);
+    worst->current_value = worst->tree.build(worst->current);
+    worst->stale = false;
+    if (cache_) worst->hash = cache_->hash(worst->current);
+
+    if (worst->current_value < worst->best_value) {
+        worst->best.assign(set.begin(), set.end());
+        worst->best_value = worst->current_value;
     }
 
+    if (worst->current_value < swarm_.gbest_value) {
+        swarm_.gbest.assign(set.begin(), set.end());
+        swarm_.gbest_value = worst->current_value;
+        ++gbest_improvements_;
+        notify(swarm_.gbest, swarm_.gbest_value);
+        return true;
+    }
+    return false;
 }
 
 
@@ -155,14 +373,13 @@ std::vector<int> PSO::difference(const std::vector<int>& a, const std::vector<in
 }
 
 std::vector<int> PSO::random_subset() const {
-    std::uniform_int_distribution<int> dist_vertex(0, n_ - 1);
     std::unordered_set<int> used;
     used.reserve(k_);
     std::vector<int> subset;
     subset.reserve(k_);
     
     while ((int)subset.size() < k_) {
-        int v = dist_vertex(rng_);
+        int v = rng_.below(n_);
         if (used.insert(v).second)
             subset.push_back(v);
     }
@@ -170,43 +387,211 @@ std::vector<int> PSO::random_subset() const {
     return subset;
 }
 
+PSO::SweepPolicy PSO::parse_sweep_policy(const std::string& name) {
+    if (name == "first") return SweepPolicy::First;
+    if (name == "best") return SweepPolicy::Best;
+    throw std::invalid_argument("Política de sweep desconocida: " + name + " (use first o best)");
+}
+
+double PSO::score_swap(IncrementalMST& tree, std::uint64_t hash, int pos, int in_v, int out_v,
+                       std::uint64_t& hits, std::uint64_t& misses) const {
+    if (!cache_)
+        return tree.evaluate_swap(pos, out_v);
+
+    double val;
+    std::uint64_t h = hash ^ cache_->token(in_v) ^ cache_->token(out_v);
+    if (cache_->lookup(h, val)) {
+        ++hits;
+    } else {
+        ++misses;
+        val = tree.evaluate_swap(pos, out_v);
+        cache_->store(h, val);
+    }
+    return val;
+}
+
 void PSO::sweep() {
+    search_seconds_ = elapsed();
+    const auto sweep_start = std::chrono::steady_clock::now();
+
     std::vector<int> best = swarm_.gbest;
-    double best_val = swarm_.gbest_value;
+    const int k = best.size();
+    const int T = std::max(1, threads_);
 
-    std::unordered_set<int> in_set(best.begin(), best.end());
+    // Un árbol por hilo: evaluate_swap guarda la base de cada posición
+    std::vector<IncrementalMST> trees(T, IncrementalMST(graph_, single_));
+    double best_val = trees[0].build(best);
+    for (int t = 1; t < T; ++t) trees[t] = trees[0];
+    std::uint64_t hash = cache_ ? cache_->hash(best) : 0;
 
+    DynamicBitset in_set(n_);
+    for (int v : best) in_set.set(v);
+
+    // Vértices de fuera que se prueban: todos o, con listas de candidatos,
+    // solo los que aparecen en la lista de algún vértice del conjunto
     std::vector<int> out_set;
     out_set.reserve(n_ - k_);
-    for (int v = 0; v < n_; ++v)
-        if (!in_set.count(v)) out_set.push_back(v);
+    DynamicBitset listed(candidates_ ? n_ : 0);
+
+    auto collect_out_set = [&]() {
+        out_set.clear();
+        if (!candidates_) {
+            for (int v = 0; v < n_; ++v)
+                if (!in_set.test(v)) out_set.push_back(v);
+            return;
+        }
 
-    bool improved = true;
-    int iteration = 0;
+        for (int u : best) {
+            const int* near = candidates_->of(u);
+            for (int t = 0; t < candidates_->size(); ++t) {
+                int v = near[t];
+                if (!in_set.test(v) && !listed.test(v)) {
+                    listed.set(v);
+                    out_set.push_back(v);
+                }
+            }
+        }
+        for (int v : out_set) listed.reset(v);
+        std::sort(out_set.begin(), out_set.end());
+    };
+    collect_out_set();
+
+    std::vector<char> dont_look(k, 0);
+    std::vector<int> adjacent;
+    adjacent.reserve(k);
+
+    // Se detiene al expirar los límites: best siempre es el mejor conjunto
+    // encontrado, así que no se pierde nada. swarm_.gbest_value no cambia
+    // hasta el final, por eso target se compara con best_val
+    while (!reached(best_val) && !expired()) {
+        // Tolerancia relativa: evita ciclos entre conjuntos empatados. Con
+        // best_val = +inf (conjunto desconectado) cualquier valor finito mejora
+        const double threshold = std::isfinite(best_val)
+                                     ? best_val - 1e-12 * std::fabs(best_val)
+                                     : std::numeric_limits<double>::max();
+        const int m = out_set.size();
+
+        // Intercambio elegido en esta pasada: (posición i, índice j en out_set)
+        int bi = -1, bj = -1;
+        double bval = threshold;
 
-    while (improved) {
-        improved = false;
-        iteration++;
+        if (sweep_policy_ == SweepPolicy::First) {
+            // El primer (i, j) mejorante en orden lexicográfico, igual que el
+            // recorrido secuencial: cada posición guarda su primer j y las
+            // posiciones mayores que la mejor encontrada se saltan
+            std::atomic<long> found(std::numeric_limits<long>::max());
+            long long evals = 0;
+            std::uint64_t hits = 0, misses = 0;
+
+            #pragma omp parallel for schedule(dynamic) num_threads(T) reduction(+:evals, hits, misses)
+            for (int i = 0; i < k; ++i) {
+                if (dont_look[i] || (long)i * m >= found.load(std::memory_order_relaxed))
+                    continue;
+
+                IncrementalMST& tree = trees[omp_get_thread_num()];
+                for (int j = 0; j < m; ++j) {
+                    double val = score_swap(tree, hash, i, best[i], out_set[j], hits, misses);
+                    ++evals;
+                    if (val < threshold) {
+                        long code = (long)i * m + j;
+                        long cur = found.load(std::memory_order_relaxed);
+                        while (code < cur && !found.compare_exchange_weak(cur, code)) {}
+                        break;
+                    }
+                }
+            }
+            evaluations_ += evals;
+            sweep_counters_.cache_hits += hits;
+            sweep_counters_.cache_misses += misses;
+
+            long code = found.load();
+            if (code != std::numeric_limits<long>::max()) {
+                bi = code / m;
+                bj = code % m;
+            }
 
-        for (size_t i = 0; i < best.size(); ++i) {
-            int in_v = best[i];
-            for (size_t j = 0; j < out_set.size(); ++j) {
-                int out_v = out_set[j];
+            // Las posiciones anteriores a bi se recorrieron completas sin
+            // mejora con cualquier reparto entre hilos; las posteriores pueden
+            // haberse evaluado o no, así que sus bits no se tocan
+            if (dlb_) {
+                const int last = bi < 0 ? k : bi;
+                for (int i = 0; i < last; ++i) dont_look[i] = 1;
+            }
+        } else {
+            // Mejor intercambio de todo el vecindario; empates por (i, j) menor
+            #pragma omp parallel num_threads(T)
+            {
+                IncrementalMST& tree = trees[omp_get_thread_num()];
+                int li = -1, lj = -1;
+                double lval = threshold;
+                long long evals = 0;
+                std::uint64_t hits = 0, misses = 0;
 
-                std::vector<int> candidate = best;
-                candidate[i] = out_v;
+                #pragma omp for schedule(dynamic)
+                for (int i = 0; i < k; ++i) {
+                    if (dont_look[i]) continue;
 
-                double val = graph_.prim_subset(candidate);
-                if (val < best_val) {
-                    best_val = val;             
-                    improved = true;
+                    bool hit = false;
+                    for (int j = 0; j < m; ++j) {
+                        double val = score_swap(tree, hash, i, best[i], out_set[j],
+                                                hits, misses);
+                        ++evals;
+                        if (val < threshold) hit = true;
+                        if (val < lval) {
+                            lval = val;
+                            li = i;
+                            lj = j;
+                        }
+                    }
+                    if (!hit && dlb_) dont_look[i] = 1;
+                }
 
-                    out_set[j] = in_v;
-                    best = std::move(candidate);
-                    break; 
+                #pragma omp critical
+                {
+                    evaluations_ += evals;
+                    sweep_counters_.cache_hits += hits;
+                    sweep_counters_.cache_misses += misses;
+                    if (li >= 0 && (bi < 0 || lval < bval ||
+                                    (lval == bval && (li < bi || (li == bi && lj < bj))))) {
+                        bval = lval;
+                        bi = li;
+                        bj = lj;
+                    }
                 }
             }
-            if (improved) break; 
+        }
+
+        if (bi < 0) break;
+
+        // Todos los árboles aplican el mismo intercambio desde el mismo estado
+        // (base de la posición bi preparada), así quedan idénticos
+        const int in_v = best[bi];
+        const int out_v = out_set[bj];
+
+        #pragma omp parallel for schedule(static) num_threads(T)
+        for (int t = 0; t < T; ++t) {
+            trees[t].evaluate_swap(bi, out_v);
+            trees[t].commit_swap(bi, out_v);
+        }
+        best_val = trees[0].weight();
+
+        if (cache_) hash ^= cache_->token(in_v) ^ cache_->token(out_v);
+        best[bi] = out_v;
+        in_set.reset(in_v);
+        in_set.set(out_v);
+
+        if (candidates_) collect_out_set();
+        else out_set[bj] = in_v;
+
+        ++sweep_moves_;
+        if (best_val < swarm_.gbest_value) notify(best, best_val);
+
+        // Don't-look bits: se reactivan la posición cambiada y sus vecinas
+        // en el nuevo árbol
+        if (dlb_) {
+            dont_look[bi] = 0;
+            trees[0].neighbors(bi, adjacent);
+            for (int x : adjacent) dont_look[x] = 0;
         }
     }
 
@@ -214,4 +599,6 @@ void PSO::sweep() {
         swarm_.gbest = std::move(best);
         swarm_.gbest_value = best_val;
     }
+
+    sweep_seconds_ = std::chrono::duration<double>(std::chrono::steady_clock::now() - sweep_start).count();
 }
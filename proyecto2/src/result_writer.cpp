@@ -0,0 +1,158 @@
+#include "../include/result_writer.hpp"
+#include "../include/json.hpp"
+#include <charconv>
+#include <stdexcept>
+
+// Campo CSV entre comillas; las comillas internas se duplican (RFC 4180)
+static void put_quoted(std::ostream& out, const std::string& s) {
+    out << '"';
+    for (char c : s) {
+        if (c == '"') out << '"';
+        out << c;
+    }
+    out << '"';
+}
+
+// Representación más corta que conserva el valor exacto
+static void put_double(std::ostream& out, double x) {
+    char buf[32];
+    auto res = std::to_chars(buf, buf + sizeof buf, x);
+    out.write(buf, res.ptr - buf);
+}
+
+ResultWriter::ResultWriter(const Graph& graph, Format format, const std::string& directory,
+                           const std::string& prefix)
+    : graph_(graph),
+      format_(format),
+      directory_(directory),
+      prefix_(prefix),
+      buffer_(1 << 20),
+      queue_(1024),
+      free_(static_cast<std::ptrdiff_t>(queue_.capacity())),
+      ready_(0),
+      done_(false)
+{
+    if (format_ != Format::Files) {
+        path_ = directory_ + "/" + prefix_ +
+                (format_ == Format::Jsonl ? "-results.jsonl" : "-results.csv");
+
+        // Búfer grande: el archivo se escribe en bloques de 1 MB
+        out_.rdbuf()->pubsetbuf(buffer_.data(), buffer_.size());
+        out_.open(path_, std::ios::trunc);
+        if (!out_.is_open())
+            throw std::runtime_error("No se pudo abrir " + path_);
+
+        if (format_ == Format::Csv)
+            out_ << "seed,weight,normalized,set,edges\n";
+    }
+
+    thread_ = std::thread(&ResultWriter::loop, this);
+}
+
+ResultWriter::~ResultWriter() {
+    close();
+}
+
+ResultWriter::Format ResultWriter::parse_format(const std::string& name) {
+    if (name == "files") return Format::Files;
+    if (name == "jsonl") return Format::Jsonl;
+    if (name == "csv") return Format::Csv;
+    throw std::invalid_argument("Formato de salida desconocido: " + name + " (use files, jsonl o csv)");
+}
+
+void ResultWriter::submit(Record record) {
+    free_.acquire();
+    // El escritor que liberó el lugar puede no haber terminado de vaciarlo
+    while (!queue_.try_push(record))
+        std::this_thread::yield();
+    ready_.release();
+}
+
+void ResultWriter::close() {
+    if (!thread_.joinable()) return;
+    done_.store(true, std::memory_order_release);
+    ready_.release();
+    thread_.join();
+    if (out_.is_open()) out_.close();
+}
+
+void ResultWriter::loop() {
+    Record r;
+    for (;;) {
+        ready_.acquire();
+        // Un productor que reservó un lugar anterior puede no haber terminado.
+        // Con done_ activo todos los submit terminaron: la cola vacía es el
+        // aviso de cierre
+        while (!queue_.try_pop(r)) {
+            if (done_.load(std::memory_order_acquire))
+                return;
+            std::this_thread::yield();
+        }
+        free_.release();
+        write(r);
+    }
+}
+
+void ResultWriter::write(const Record& r) {
+    switch (format_) {
+        case Format::Files: write_file(r); break;
+        case Format::Jsonl: write_jsonl(r); break;
+        case Format::Csv:   write_csv(r); break;
+    }
+}
+
+void ResultWriter::write_file(const Record& r) {
+    // Mismo contenido que escribía main.cpp por semilla
+    std::ofstream out(directory_ + "/" + prefix_ + "-" + std::to_string(r.seed) + ".mst");
+    out << "# Resultados PSO - Semilla " << r.seed << "\n";
+    out << "# Mejor conjunto (gbest): ";
+    for (int v : r.set) out << graph_.get_vertex_name(v) << " ";
+    out << "\n# Peso total normalizado: " << r.value / graph_.getNormalizador() << "\n";
+    out << "# Aristas del MST:\n";
+    out << graph_.mst_to_string(r.set, r.parent);
+}
+
+void ResultWriter::write_jsonl(const Record& r) {
+    const auto& adj = graph_.adjacency();
+
+    JsonWriter w(out_, false);
+    w.begin_object();
+    w.key("seed").value(r.seed);
+    w.key("weight").value(r.value);
+    w.key("normalized").value(r.value / graph_.getNormalizador());
+
+    w.key("set").begin_array();
+    for (int v : r.set) w.value(graph_.get_vertex_name(v));
+    w.end_array();
+
+    w.key("edges").begin_array();
+    for (size_t i = 0; i < r.set.size(); ++i) {
+        if (r.parent[i] == -1) continue;
+        int a = r.set[r.parent[i]], b = r.set[i];
+        w.begin_array();
+        w.value(graph_.get_vertex_name(a)).value(graph_.get_vertex_name(b)).value(adj[a][b]);
+        w.end_array();
+    }
+    w.end_array();
+    w.end_object();
+}
+
+void ResultWriter::write_csv(const Record& r) {
+    // set: nombres separados por espacios; edges: formato de mst_to_string
+    // ("a,b,w;..."), entre comillas porque contiene comas; los nombres de
+    // vértice pueden traer comillas
+    out_ << r.seed << ',';
+    put_double(out_, r.value);
+    out_ << ',';
+    put_double(out_, r.value / graph_.getNormalizador());
+    out_ << ',';
+    std::string set;
+    for (size_t i = 0; i < r.set.size(); ++i) {
+        if (i) set += ' ';
+        set += graph_.get_vertex_name(r.set[i]);
+    }
+    put_quoted(out_, set);
+    out_ << ',';
+    put_quoted(out_, graph_.mst_to_string(r.set, r.parent));
+    out_ << '\n';
+}
@@ -0,0 +1,409 @@
+#include "../include/server.hpp"
+#include "../include/json.hpp"
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <cstring>
+#include <omp.h>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+volatile std::sig_atomic_t stop_requested = 0;
+
+void on_signal(int) { stop_requested = 1; }
+
+// Una línea más larga se considera un cliente roto
+constexpr std::size_t MAX_LINE = 1 << 20;
+
+const JsonValue* field(const JsonValue& message, const char* key) {
+    const JsonValue* v = message.find(key);
+    return (v && !v->is_null()) ? v : nullptr;
+}
+
+long long integer_field(const JsonValue& message, const char* key, long long fallback) {
+    const JsonValue* v = field(message, key);
+    if (!v) return fallback;
+    double x = v->as_number();
+    if (x != std::floor(x) || std::fabs(x) > 9e15)
+        throw std::invalid_argument(std::string("\"") + key + "\" debe ser entero");
+    return static_cast<long long>(x);
+}
+
+// Entero en [lo, hi]; cualquier otro valor es un error de la solicitud
+long long bounded_field(const JsonValue& message, const char* key, long long fallback,
+                        long long lo, long long hi) {
+    long long x = integer_field(message, key, fallback);
+    if (x < lo || x > hi)
+        throw std::invalid_argument(std::string("\"") + key + "\" fuera de rango [" +
+                                    std::to_string(lo) + ", " + std::to_string(hi) + "]");
+    return x;
+}
+
+// Número finito; el fallback puede no serlo (target = -inf: sin objetivo).
+// Un time infinito tampoco se acepta: sin límite se pide con 0 u omitiéndolo
+double finite_field(const JsonValue& message, const char* key, double fallback) {
+    const JsonValue* v = field(message, key);
+    if (!v) return fallback;
+    double x = v->as_number();
+    if (!std::isfinite(x))
+        throw std::invalid_argument(std::string("\"") + key + "\" debe ser un número finito");
+    return x;
+}
+
+// El id se devuelve tal cual si es cadena; un número se convierte a texto
+std::string message_id(const JsonValue& message) {
+    const JsonValue* v = field(message, "id");
+    if (!v) return "";
+    if (v->is_string()) return v->as_string();
+    std::ostringstream out;
+    out << v->as_number();
+    return out.str();
+}
+
+double seconds_since(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t).count();
+}
+
+}
+
+/**
+ * Conexión de un cliente. Los trabajadores escriben sus respuestas con
+ * send_line bajo write_mutex; el descriptor se cierra cuando ya no queda
+ * ningún trabajo que la use.
+ */
+struct Server::Connection {
+    int fd;
+    std::mutex write_mutex;
+    bool broken = false;              // el cliente se fue: se descartan las respuestas
+    std::atomic<bool> done{false};    // el hilo lector terminó
+
+    explicit Connection(int fd) : fd(fd) {}
+    ~Connection() { ::close(fd); }
+
+    // Con SO_SNDTIMEO, un cliente que no lee hace fallar send() con EAGAIN:
+    // la conexión se da por rota y se cierra también para el lector
+    void send_line(const std::string& line) {
+        std::lock_guard<std::mutex> lock(write_mutex);
+        std::size_t sent = 0;
+        while (!broken && sent < line.size()) {
+            ssize_t n = ::send(fd, line.data() + sent, line.size() - sent, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR) continue;
+            if (n <= 0) {
+                broken = true;
+                ::shutdown(fd, SHUT_RDWR);
+            } else {
+                sent += n;
+            }
+        }
+    }
+
+    void send_error(const std::string& id, const std::string& message) {
+        std::ostringstream out;
+        JsonWriter w(out, false);
+        w.begin_object();
+        w.key("id").value(id);
+        w.key("type").value("error");
+        w.key("message").value(message);
+        w.end_object();
+        send_line(out.str());
+    }
+};
+
+Server::Server(std::string socket_path, Options options)
+    : socket_path_(std::move(socket_path)),
+      options_(options),
+      queue_(std::max<std::size_t>(options.queue, 1)),
+      free_(static_cast<std::ptrdiff_t>(std::max<std::size_t>(options.queue, 1))),
+      ready_(0)
+{
+    if (options_.workers <= 0)
+        options_.workers = omp_get_max_threads();
+}
+
+Server::~Server() = default;
+
+void Server::add_graph(const std::string& id, Graph graph) {
+    if (solvers_.count(id))
+        throw std::invalid_argument("Grafo repetido: " + id);
+    auto solver = std::make_unique<Solver>(std::move(graph));
+    solver->set_cache_limit(options_.prepared);
+    solvers_.emplace(id, std::move(solver));
+}
+
+void Server::run() {
+    int listener = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+        throw std::runtime_error(std::string("socket: ") + std::strerror(errno));
+
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    if (socket_path_.size() >= sizeof(addr.sun_path)) {
+        ::close(listener);
+        throw std::runtime_error("Ruta de socket demasiado larga: " + socket_path_);
+    }
+    std::strcpy(addr.sun_path, socket_path_.c_str());
+    ::unlink(socket_path_.c_str());
+    if (::bind(listener, reinterpret_cast<sockaddr*>(&addr), sizeof addr) < 0 ||
+        ::listen(listener, 64) < 0) {
+        std::string error = std::strerror(errno);
+        ::close(listener);
+        throw std::runtime_error("No se pudo escuchar en " + socket_path_ + ": " + error);
+    }
+
+    stop_requested = 0;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+
+    // Cada trabajador reparte sus semillas en su parte de los hilos
+    const int threads = std::max(1, omp_get_max_threads() / options_.workers);
+    for (int i = 0; i < options_.workers; ++i)
+        workers_.emplace_back(&Server::work, this, threads);
+
+    while (!stop_requested) {
+        pollfd p{listener, POLLIN, 0};
+        int ready = ::poll(&p, 1, 200);
+
+        // Conexiones cuyo lector ya terminó
+        {
+            std::lock_guard<std::mutex> lock(connections_mutex_);
+            for (auto it = connections_.begin(); it != connections_.end();) {
+                if (it->first->done) {
+                    it->second.join();
+                    it = connections_.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+        }
+
+        if (ready <= 0 || !(p.revents & POLLIN))
+            continue;
+        int fd = ::accept(listener, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+
+        timeval timeout{};
+        timeout.tv_sec = static_cast<time_t>(options_.send_timeout);
+        timeout.tv_usec = static_cast<suseconds_t>(
+            (options_.send_timeout - std::floor(options_.send_timeout)) * 1e6);
+        ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof timeout);
+
+        auto connection = std::make_shared<Connection>(fd);
+        std::lock_guard<std::mutex> lock(connections_mutex_);
+        connections_.emplace_back(connection, std::thread(&Server::serve, this, connection));
+    }
+
+    // --- Cierre: no se aceptan ni se leen más solicitudes; las encoladas se responden ---
+    ::close(listener);
+    ::unlink(socket_path_.c_str());
+
+    for (auto& [connection, reader] : connections_) {
+        ::shutdown(connection->fd, SHUT_RD);
+        reader.join();
+    }
+    for (size_t i = 0; i < workers_.size(); ++i)
+        submit(nullptr);
+    for (auto& w : workers_)
+        w.join();
+    workers_.clear();
+    connections_.clear();
+
+    std::signal(SIGINT, SIG_DFL);
+    std::signal(SIGTERM, SIG_DFL);
+}
+
+void Server::serve(std::shared_ptr<Connection> connection) {
+    std::string buffer;
+    char chunk[1 << 16];
+
+    for (;;) {
+        ssize_t n = ::recv(connection->fd, chunk, sizeof chunk, 0);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        buffer.append(chunk, n);
+
+        std::size_t start = 0, end;
+        while ((end = buffer.find('\n', start)) != std::string::npos) {
+            std::string line = buffer.substr(start, end - start);
+            start = end + 1;
+            if (line.find_first_not_of(" \t\r") == std::string::npos)
+                continue;
+
+            std::string id;
+            try {
+                JsonValue message = JsonValue::parse(line);
+                id = message_id(message);
+                std::unique_ptr<Job> job = make_job(message);
+                job->connection = connection;
+                job->id = id;
+                submit(std::move(job));     // bloquea si la cola está llena
+            } catch (const std::exception& e) {
+                connection->send_error(id, e.what());
+            }
+        }
+        buffer.erase(0, start);
+
+        if (buffer.size() > MAX_LINE) {
+            connection->send_error("", "Línea demasiado larga");
+            break;
+        }
+    }
+    connection->done = true;
+}
+
+std::unique_ptr<Server::Job> Server::make_job(const JsonValue& message) const {
+    if (!message.is_object())
+        throw std::invalid_argument("La solicitud debe ser un objeto JSON");
+
+    auto job = std::make_unique<Job>();
+
+    if (const JsonValue* g = field(message, "graph")) {
+        auto it = solvers_.find(g->as_string());
+        if (it == solvers_.end())
+            throw std::invalid_argument("Grafo desconocido: " + g->as_string());
+        job->solver = it->second.get();
+    } else if (solvers_.size() == 1) {
+        job->solver = solvers_.begin()->second.get();
+    } else {
+        throw std::invalid_argument("Falta \"graph\" (hay varios grafos cargados)");
+    }
+
+    Solver::Request& r = job->request;
+    const int n = job->solver->graph().num_vertices();
+    if (!field(message, "k"))
+        throw std::invalid_argument("Falta \"k\"");
+    r.k = bounded_field(message, "k", 0, 1, n);
+
+    r.swarm_size = bounded_field(message, "swarm", 20, 1, MAX_SWARM);
+    r.stagnation = bounded_field(message, "stagnation", 10000, 0, MAX_ITERATIONS);
+    r.seconds = finite_field(message, "time", 0.0);
+    r.evaluations = bounded_field(message, "max_evals", 0, 0,
+                                  std::numeric_limits<long long>::max());
+    r.target = finite_field(message, "target", -std::numeric_limits<double>::infinity());
+    r.gap = finite_field(message, "gap", 0.0);
+    r.neighbors = bounded_field(message, "neighbors", 0, 0, n);
+    if (r.seconds < 0.0)
+        throw std::invalid_argument("\"time\" no puede ser negativo");
+    if (r.gap < 0.0 || r.gap >= 1.0)
+        throw std::invalid_argument("\"gap\" fuera de rango [0, 1)");
+
+    if (const JsonValue* s = field(message, "seeds")) {
+        if ((long long)s->as_array().size() > MAX_SEEDS)
+            throw std::invalid_argument("Demasiadas semillas (máximo " +
+                                        std::to_string(MAX_SEEDS) + ")");
+        for (const JsonValue& seed : s->as_array()) {
+            double x = seed.as_number();
+            if (x < 0 || x != std::floor(x) || x > 4294967295.0)
+                throw std::invalid_argument("Semilla inválida");
+            r.seeds.push_back(static_cast<unsigned>(x));
+        }
+    }
+    if (r.seeds.empty())
+        r.seeds.push_back(1);
+
+    if (const JsonValue* s = field(message, "sweep"))
+        r.sweep = PSO::parse_sweep_policy(s->as_string());
+    if (const JsonValue* d = field(message, "dlb"))
+        r.dlb = d->as_bool();
+    if (const JsonValue* f = field(message, "float32"))
+        r.single_precision = f->as_bool();
+    if (const JsonValue* t = field(message, "islands")) {
+        r.islands = true;
+        r.topology = IslandModel::parse_topology(t->as_string());
+        r.migrate_every = bounded_field(message, "migrate_every", 100, 1, MAX_ITERATIONS);
+    }
+
+    job->queued = std::chrono::steady_clock::now();
+    return job;
+}
+
+void Server::submit(std::unique_ptr<Job> job) {
+    free_.acquire();
+    while (!queue_.try_push(job))
+        std::this_thread::yield();
+    ready_.release();
+}
+
+void Server::work(int threads) {
+    omp_set_num_threads(threads);
+
+    for (;;) {
+        ready_.acquire();
+        std::unique_ptr<Job> job;
+        // Un productor que reservó un lugar anterior puede no haber terminado
+        while (!queue_.try_pop(job))
+            std::this_thread::yield();
+        free_.release();
+
+        if (!job)
+            return;       // centinela de cierre
+        execute(*job);
+    }
+}
+
+void Server::execute(Job& job) {
+    Connection& connection = *job.connection;
+    const double queue_seconds = seconds_since(job.queued);
+    const auto started = std::chrono::steady_clock::now();
+
+    job.request.on_result = [&](const Solver::SeedResult& s) {
+        std::ostringstream out;
+        JsonWriter w(out, false);
+        w.begin_object();
+        w.key("id").value(job.id);
+        w.key("type").value("seed");
+        w.key("k").value(s.k);
+        w.key("seed").value(s.seed);
+        w.key("weight").value(s.value);
+        w.key("normalized").value(s.normalized);
+        w.end_object();
+        connection.send_line(out.str());
+    };
+
+    try {
+        Solver::Result result = job.solver->solve(job.request);
+        std::shared_ptr<const Graph> g = job.solver->prepare(job.request.k);
+        const Solver::SeedResult& best = result.best;
+        const auto& adj = g->adjacency();
+
+        std::ostringstream out;
+        JsonWriter w(out, false);
+        w.begin_object();
+        w.key("id").value(job.id);
+        w.key("type").value("done");
+        w.key("k").value(job.request.k);
+        w.key("seed").value(best.seed);
+        w.key("weight").value(best.value);
+        w.key("normalized").value(best.normalized);
+        w.key("lower_bound").value(result.lower_bound);
+        w.key("gap").value(result.gap);
+
+        w.key("set").begin_array();
+        for (int v : best.set) w.value(g->get_vertex_name(v));
+        w.end_array();
+
+        w.key("edges").begin_array();
+        for (size_t i = 0; i < best.set.size(); ++i) {
+            if (best.parent[i] == -1) continue;
+            int a = best.set[best.parent[i]], b = best.set[i];
+            w.begin_array();
+            w.value(g->get_vertex_name(a)).value(g->get_vertex_name(b)).value(adj[a][b]);
+            w.end_array();
+        }
+        w.end_array();
+
+        w.key("queue_seconds").value(queue_seconds);
+        w.key("search_seconds").value(seconds_since(started));
+        w.end_object();
+        connection.send_line(out.str());
+    } catch (const std::exception& e) {
+        connection.send_error(job.id, e.what());
+    }
+}
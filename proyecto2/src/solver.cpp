@@ -0,0 +1,326 @@
+#include "../include/solver.hpp"
+#include "../include/candidate_lists.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <exception>
+#include <omp.h>
+#include <stdexcept>
+#include <string>
+
+Solver::Solver(Graph graph, int only_k) : only_k_(std::max(only_k, 0)) {
+    if (only_k > graph.num_vertices())
+        throw std::invalid_argument("k fuera de rango: " + std::to_string(only_k));
+
+    // Con pares a distancia +inf la completación no da pesos finitos y la
+    // búsqueda no tiene árbol que mejorar
+    graph.compute_distances();
+    if (!graph.connected())
+        throw std::invalid_argument("La gráfica no es conexa: hay vértices sin camino entre sí");
+
+    if (only_k_ == 0) {
+        base_ = std::make_shared<const Graph>(std::move(graph));
+        return;
+    }
+
+    // Mismo resultado que Graph::completed(k), sin la segunda matriz
+    graph.complete(only_k);
+    graph.calcula_Normalizador(only_k);
+    base_ = std::make_shared<const Graph>(std::move(graph));
+    prepared_.emplace(only_k, base_);
+}
+
+std::shared_ptr<const Graph> Solver::prepare(int k) const {
+    if (k < 1 || k > base_->num_vertices())
+        throw std::invalid_argument("k fuera de rango: " + std::to_string(k));
+    if (only_k_ > 0 && k != only_k_)
+        throw std::invalid_argument("Solver preparado solo para k=" + std::to_string(only_k_));
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = prepared_.find(k);
+        if (it != prepared_.end()) {
+            touch(k);
+            return it->second;
+        }
+    }
+
+    // Fuera del candado para que varios k se preparen a la vez; si dos
+    // hilos preparan el mismo k, se queda la primera copia insertada
+    auto g = std::make_shared<const Graph>(base_->completed(k));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto [it, inserted] = prepared_.emplace(k, std::move(g));
+    touch(k);
+    if (inserted)
+        evict();
+    return it->second;
+}
+
+void Solver::set_cache_limit(std::size_t ks) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = ks;
+    evict();
+}
+
+void Solver::release(int k) const {
+    if (k == only_k_)
+        return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    forget(k);
+}
+
+void Solver::touch(int k) const {
+    recent_.remove(k);
+    recent_.push_front(k);
+}
+
+void Solver::evict() const {
+    while (limit_ > 0 && prepared_.size() > limit_ && !recent_.empty()) {
+        int k = recent_.back();
+        if (k == only_k_) break;
+        forget(k);
+    }
+}
+
+void Solver::forget(int k) const {
+    recent_.remove(k);
+    prepared_.erase(k);
+    bounds_.erase(k);
+    singles_.erase(k);
+    candidates_.erase(k);
+}
+
+std::shared_ptr<const CandidateLists> Solver::candidate_lists(int k, int m) const {
+    auto g = prepare(k);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = candidates_.find(k);
+        if (it != candidates_.end() && it->second.first == m)
+            return it->second.second;
+    }
+
+    auto lists = std::make_shared<const CandidateLists>(*g, m);
+
+    // Solo se guarda si k sigue preparado (pudo desalojarse mientras tanto);
+    // un M distinto reemplaza al anterior
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (prepared_.count(k))
+        candidates_[k] = {m, lists};
+    return lists;
+}
+
+std::shared_ptr<const LowerBounds> Solver::lower_bounds(int k) const {
+    auto g = prepare(k);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = bounds_.find(k);
+        if (it != bounds_.end())
+            return it->second;
+    }
+
+    auto bounds = std::make_shared<const LowerBounds>(*g, k);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!prepared_.count(k))
+        return bounds;
+    return bounds_.emplace(k, std::move(bounds)).first->second;
+}
+
+std::shared_ptr<const DenseMatrix32> Solver::single_precision(int k) const {
+    auto g = prepare(k);
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = singles_.find(k);
+        if (it != singles_.end())
+            return it->second;
+    }
+
+    auto weights = std::make_shared<const DenseMatrix32>(g->adjacency());
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!prepared_.count(k))
+        return weights;
+    return singles_.emplace(k, std::move(weights)).first->second;
+}
+
+Solver::Result Solver::solve(const Request& request) const {
+    if (request.seeds.empty())
+        throw std::invalid_argument("La solicitud no tiene semillas");
+    if (request.swarm_size < 1)
+        throw std::invalid_argument("swarm_size debe ser positivo");
+
+    std::shared_ptr<const Graph> g = prepare(request.k);
+    std::shared_ptr<const CandidateLists> lists;
+    if (request.neighbors > 0)
+        lists = candidate_lists(request.k, request.neighbors);
+    std::shared_ptr<const DenseMatrix32> single;
+    if (request.single_precision)
+        single = single_precision(request.k);
+
+    // Escrito para que NaN no pase: las comparaciones con NaN son falsas
+    if (!(request.gap >= 0.0 && request.gap < 1.0))
+        throw std::invalid_argument("gap debe estar en [0, 1)");
+    if (!(request.seconds >= 0.0))
+        throw std::invalid_argument("seconds no puede ser negativo ni NaN");
+    if (std::isnan(request.target))
+        throw std::invalid_argument("target no puede ser NaN");
+
+    Result result;
+    result.normalizer = g->getNormalizador();
+    result.lower_bound = lower_bounds(request.k)->value();
+    result.runs.resize(request.seeds.size());
+
+    // El objetivo de la solicitud está normalizado; PSO compara pesos.
+    // La brecha se traduce en otro objetivo: f <= cota / (1 - gap). Con
+    // gap > 0 la primera semilla que lo alcanza detiene a las demás
+    std::atomic<bool> stop(false);
+    PSO::Limits limits;
+    limits.seconds = request.seconds;
+    limits.evaluations = request.evaluations;
+    // (la tolerancia relativa absorbe el orden distinto de las sumas: un
+    // gbest que iguala la cota puede quedar unos ulp arriba)
+    limits.target = std::max(request.target * result.normalizer,
+                             result.lower_bound * (1.0 + 1e-12) / (1.0 - request.gap));
+    if (request.gap > 0.0)
+        limits.stop = &stop;
+
+    if (request.islands)
+        run_islands(*g, request, limits, lists.get(), single.get(), result.runs);
+    else
+        run_seeds(*g, request, limits, lists.get(), single.get(), result.runs);
+
+    // Estricto: en empate gana la primera semilla, sin importar qué hilo terminó antes
+    size_t best = 0;
+    for (size_t i = 1; i < result.runs.size(); ++i)
+        if (result.runs[i].value < result.runs[best].value)
+            best = i;
+    result.best = result.runs[best];
+    result.gap = LowerBounds::gap(result.best.value, result.lower_bound);
+    return result;
+}
+
+std::vector<Solver::Result> Solver::solve_batch(const Request& request,
+                                                const std::vector<int>& ks) const {
+    std::vector<Result> results(ks.size());
+    if (ks.size() == 1) {
+        Request r = request;
+        r.k = ks[0];
+        results[0] = solve(r);
+        return results;
+    }
+
+    // Los k mayores cuestan más: se reparten primero (schedule dinámico)
+    std::vector<size_t> order(ks.size());
+    for (size_t i = 0; i < order.size(); ++i) order[i] = i;
+    std::stable_sort(order.begin(), order.end(),
+                     [&](size_t a, size_t b) { return ks[a] > ks[b]; });
+
+    // Con threads > 0 cada k usa ese número de hilos para sus partículas:
+    // el pool se divide para no sobresuscribirlo
+    int batch_threads = omp_get_max_threads();
+    if (request.threads > 0)
+        batch_threads = std::max(1, batch_threads / request.threads);
+
+    // Excepciones de OpenMP: se guarda la primera y se relanza al final
+    std::exception_ptr error;
+
+    #pragma omp parallel for schedule(dynamic, 1) num_threads(batch_threads)
+    for (size_t j = 0; j < order.size(); ++j) {
+        const size_t i = order[j];
+        try {
+            Request r = request;
+            r.k = ks[i];
+            results[i] = solve(r);
+        } catch (...) {
+            #pragma omp critical(solve_batch)
+            if (!error) error = std::current_exception();
+        }
+    }
+
+    if (error)
+        std::rethrow_exception(error);
+    return results;
+}
+
+namespace {
+
+// Con rescore, el peso de la búsqueda (float) se reemplaza por el del MST
+// calculado en double sobre la matriz completada
+Solver::SeedResult make_result(const Graph& g, int k, unsigned seed, int thread,
+                               const PSO& pso, bool rescore) {
+    Solver::SeedResult r;
+    r.k = k;
+    r.seed = seed;
+    r.thread = thread;
+    r.set = pso.best_set();
+    auto [parent, exact] = g.prim_subset_full(r.set);
+    r.parent = std::move(parent);
+    r.value = rescore ? exact : pso.best_value();
+    r.normalized = r.value / g.getNormalizador();
+    r.stats = pso.stats();
+    return r;
+}
+
+}
+
+void Solver::run_islands(const Graph& g, const Request& request, const PSO::Limits& limits,
+                         const CandidateLists* candidates, const DenseMatrix32* single,
+                         std::vector<SeedResult>& runs) const {
+    // Las semillas son las islas; migran sus gbest cada migrate_every iteraciones
+    IslandModel model(g, request.k, request.swarm_size, request.stagnation,
+                      request.seeds, request.topology, request.migrate_every);
+    model.set_cache(request.cache);
+    model.set_sweep(request.sweep, request.dlb);
+    model.set_candidates(candidates);
+    model.set_single_precision(single);
+    model.set_limits(limits);
+    model.set_anytime(request.anytime);
+    model.set_telemetry(request.telemetry);
+    model.run();
+    model.sweep();
+
+    for (int i = 0; i < model.size(); ++i) {
+        runs[i] = make_result(g, request.k, request.seeds[i], -1, model.island(i),
+                              single != nullptr);
+        if (request.on_result)
+            request.on_result(runs[i]);
+    }
+}
+
+void Solver::run_seeds(const Graph& g, const Request& request, const PSO::Limits& limits,
+                       const CandidateLists* candidates, const DenseMatrix32* single,
+                       std::vector<SeedResult>& runs) const {
+    // Con threads > 0 los hilos se reparten entre semillas y partículas.
+    // Dentro de otra región (solve_batch) el pool ya está repartido entre
+    // los k: las semillas de este k corren en el hilo que lo tomó
+    int seed_threads = omp_in_parallel() ? 1 : omp_get_max_threads();
+    if (request.threads > 0)
+        seed_threads = std::max(1, seed_threads / request.threads);
+
+    #pragma omp parallel for schedule(dynamic) num_threads(seed_threads)
+    for (size_t i = 0; i < request.seeds.size(); ++i) {
+        unsigned seed = request.seeds[i];
+
+        PSO pso(g, request.k, request.swarm_size, request.stagnation, 0.6, 0.3, seed);
+        pso.set_threads(request.threads);
+        pso.set_cache(request.cache);
+        pso.set_sweep(request.sweep, request.dlb);
+        pso.set_candidates(candidates);
+        pso.set_single_precision(single);
+        pso.set_limits(limits);
+        pso.set_anytime(request.anytime);
+        pso.set_telemetry(request.telemetry);
+        pso.initialize();
+        pso.run();
+        pso.sweep();
+
+        runs[i] = make_result(g, request.k, seed, omp_get_thread_num(), pso,
+                              single != nullptr);
+        if (request.on_result)
+            request.on_result(runs[i]);
+    }
+}
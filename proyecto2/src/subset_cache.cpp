@@ -0,0 +1,61 @@
+#include "../include/subset_cache.hpp"
+#include <bit>
+
+namespace {
+
+// splitmix64: claves Zobrist reproducibles a partir de una semilla
+std::uint64_t splitmix64(std::uint64_t& state) {
+    std::uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+}
+
+SubsetCache::SubsetCache(int n, std::size_t megabytes, std::uint64_t seed)
+    : zobrist_(n)
+{
+    std::uint64_t state = seed;
+    for (auto& z : zobrist_)
+        z = splitmix64(state);
+
+    // Mayor potencia de 2 que cabe en la memoria pedida (al menos una casilla)
+    std::size_t count = (megabytes << 20) / sizeof(Slot);
+    count = count ? std::bit_floor(count) : 1;
+    mask_ = count - 1;
+
+    // Casillas vacías: check = 1 no reconstruye ningún hash real salvo
+    // h = 1 con valor 0, lo cual no ocurre en la práctica
+    table_ = std::make_unique<Slot[]>(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        table_[i].check.store(1, std::memory_order_relaxed);
+        table_[i].value.store(0, std::memory_order_relaxed);
+    }
+}
+
+std::uint64_t SubsetCache::hash(const std::vector<int>& vertices) const {
+    std::uint64_t h = 0;
+    for (int v : vertices)
+        h ^= zobrist_[v];
+    return h;
+}
+
+bool SubsetCache::lookup(std::uint64_t h, double& value) const {
+    const Slot& s = table_[h & mask_];
+    std::uint64_t check = s.check.load(std::memory_order_relaxed);
+    std::uint64_t bits = s.value.load(std::memory_order_relaxed);
+
+    if ((check ^ bits) != h)
+        return false;
+
+    value = std::bit_cast<double>(bits);
+    return true;
+}
+
+void SubsetCache::store(std::uint64_t h, double value) {
+    Slot& s = table_[h & mask_];
+    std::uint64_t bits = std::bit_cast<std::uint64_t>(value);
+    s.check.store(h ^ bits, std::memory_order_relaxed);
+    s.value.store(bits, std::memory_order_relaxed);
+}
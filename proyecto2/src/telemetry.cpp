@@ -0,0 +1,134 @@
+#include "../include/telemetry.hpp"
+#include "../include/json.hpp"
+#include "../include/subset_cache.hpp"
+#include <map>
+
+namespace telemetry {
+
+const char* branch_name(int branch) {
+    switch (branch) {
+        case GBEST: return "gbest";
+        case PBEST: return "pbest";
+        default:    return "random";
+    }
+}
+
+Counters& Counters::operator+=(const Counters& other) {
+    for (int b = 0; b < BRANCHES; ++b) {
+        proposals[b] += other.proposals[b];
+        no_candidates[b] += other.no_candidates[b];
+        accepted[b] += other.accepted[b];
+        pbest_updates[b] += other.pbest_updates[b];
+    }
+    cache_hits += other.cache_hits;
+    cache_misses += other.cache_misses;
+    return *this;
+}
+
+void PhaseTimer::start(const std::string& phase) {
+    stop();
+    phases_.emplace_back(phase, 0.0);
+    begin_ = Clock::now();
+    running_ = true;
+}
+
+void PhaseTimer::stop() {
+    if (!running_) return;
+    phases_.back().second = std::chrono::duration<double>(Clock::now() - begin_).count();
+    running_ = false;
+}
+
+void write_report(std::ostream& out, const RunInfo& info, const PhaseTimer& phases,
+                  const std::vector<SeedReport>& seeds, const SubsetCache* cache) {
+    JsonWriter w(out);
+    w.begin_object();
+    w.key("input").value(info.input);
+    w.key("k").value(info.k);
+    w.key("swarm_size").value(info.swarm_size);
+    w.key("threads").value(info.threads);
+    w.key("islands").value(info.islands);
+
+    // --- Fases ---
+    double total = 0.0;
+    w.key("phases").begin_object();
+    for (const auto& [name, seconds] : phases.phases()) {
+        w.key(name).value(seconds);
+        total += seconds;
+    }
+    w.key("total").value(total);
+    w.end_object();
+
+    // --- Semillas ---
+    w.key("seeds").begin_array();
+    for (const SeedReport& r : seeds) {
+        const SearchStats& s = r.stats;
+        double seconds = s.search_seconds + s.sweep_seconds;
+
+        w.begin_object();
+        w.key("seed").value(r.seed);
+        w.key("thread").value(r.thread);
+        w.key("value").value(r.value);
+        w.key("normalized").value(r.normalized);
+        w.key("search_seconds").value(s.search_seconds);
+        w.key("sweep_seconds").value(s.sweep_seconds);
+        w.key("evaluations").value(s.evaluations);
+        w.key("evaluations_per_second").value(seconds > 0 ? s.evaluations / seconds : 0.0);
+        w.key("gbest_improvements").value(s.gbest_improvements);
+        w.key("sweep_moves").value(s.sweep_moves);
+
+        w.key("branches").begin_object();
+        for (int b = 0; b < BRANCHES; ++b) {
+            const Counters& c = s.counters;
+            std::uint64_t moved = c.proposals[b] - c.no_candidates[b];
+            w.key(branch_name(b)).begin_object();
+            w.key("proposals").value(c.proposals[b]);
+            w.key("no_candidates").value(c.no_candidates[b]);
+            w.key("accepted").value(c.accepted[b]);
+            w.key("acceptance_rate").value(moved ? double(c.accepted[b]) / moved : 0.0);
+            w.key("pbest_updates").value(c.pbest_updates[b]);
+            w.end_object();
+        }
+        w.end_object();
+        w.end_object();
+    }
+    w.end_array();
+
+    // --- Resumen por hilo ---
+    struct ThreadTotals { int runs = 0; std::uint64_t evaluations = 0; double seconds = 0.0; };
+    std::map<int, ThreadTotals> per_thread;
+    for (const SeedReport& r : seeds) {
+        ThreadTotals& t = per_thread[r.thread];
+        t.runs += 1;
+        t.evaluations += r.stats.evaluations;
+        t.seconds += r.stats.search_seconds + r.stats.sweep_seconds;
+    }
+
+    w.key("per_thread").begin_array();
+    for (const auto& [thread, t] : per_thread) {
+        w.begin_object();
+        w.key("thread").value(thread);
+        w.key("runs").value(t.runs);
+        w.key("evaluations").value(t.evaluations);
+        w.key("seconds").value(t.seconds);
+        w.key("evaluations_per_second").value(t.seconds > 0 ? t.evaluations / t.seconds : 0.0);
+        w.end_object();
+    }
+    w.end_array();
+
+    if (cache) {
+        // Cada corrida cuenta sus propias consultas; aquí se suman
+        Counters total;
+        for (const SeedReport& r : seeds)
+            total += r.stats.counters;
+
+        w.key("subset_cache").begin_object();
+        w.key("slots").value(static_cast<unsigned long long>(cache->slots()));
+        w.key("hits").value(total.cache_hits);
+        w.key("misses").value(total.cache_misses);
+        w.end_object();
+    }
+
+    w.end_object();
+}
+
+}
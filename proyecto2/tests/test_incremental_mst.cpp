@@ -0,0 +1,139 @@
+#include "../include/graph.hpp"
+#include "../include/incremental_mst.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <vector>
+
+/**
+ * Prueba aleatoria de IncrementalMST contra Graph::prim_subset.
+ *
+ * Sobre grafos completos con pesos enteros (muchos empates) y sobre grafos
+ * dispersos completados con complete(k), conexos y con dos componentes,
+ * aplica intercambios aleatorios: cada evaluate_swap y cada commit_swap debe
+ * dar el mismo total que Prim desde cero sobre el conjunto resultante (+inf
+ * en ambos si el conjunto queda desconectado). Se cuentan las remociones de
+ * hojas y de vértices internos y los conjuntos desconectados para asegurar
+ * que se probaron todos los casos.
+ */
+
+static int failures = 0;
+static long leaf_removals = 0;
+static long internal_removals = 0;
+static long disconnected_sets = 0;
+
+// a == b cubre el caso +inf == +inf (subconjunto desconectado)
+static bool close(double a, double b) {
+    return a == b || std::fabs(a - b) <= 1e-9 * std::max(1.0, std::fabs(b));
+}
+
+static void check(bool ok, const char* what, int n, int k, int round) {
+    if (!ok) {
+        std::fprintf(stderr, "FALLA: %s (n=%d, k=%d, ronda %d)\n", what, n, k, round);
+        ++failures;
+    }
+}
+
+// --- Grafos de prueba ---
+
+// Completo con pesos enteros en [1, max_w]: con max_w chico hay muchos empates
+static Graph complete_graph(int n, int max_w, std::mt19937& rng) {
+    Graph g(n);
+    std::uniform_int_distribution<int> w(1, max_w);
+    for (int u = 0; u < n; ++u)
+        for (int v = u + 1; v < n; ++v)
+            g.add_edge(u, v, w(rng));
+    return g;
+}
+
+// Disperso (camino + aristas al azar), completado para k. Con components = 2
+// los vértices [0, n/2) y [n/2, n) quedan sin camino entre sí
+static Graph sparse_graph(int n, int k, std::mt19937& rng, int components = 1) {
+    Graph g(n);
+    std::uniform_real_distribution<double> w(0.5, 10.0);
+    const int half = components == 2 ? n / 2 : n;
+    auto side = [&](int v) { return v < half; };
+    for (int v = 1; v < n; ++v)
+        if (side(v - 1) == side(v)) g.add_edge(v - 1, v, w(rng));
+    std::uniform_int_distribution<int> pick(0, n - 1);
+    for (int e = 0; e < 2 * n; ++e) {
+        int u = pick(rng), v = pick(rng);
+        if (u != v && side(u) == side(v)) g.add_edge(u, v, w(rng));
+    }
+    g.compute_distances();
+    return g.completed(k);
+}
+
+// --- Intercambios aleatorios ---
+
+static void run_swaps(const Graph& g, int k, int rounds, std::mt19937& rng) {
+    const int n = g.num_vertices();
+
+    std::vector<int> perm(n);
+    std::iota(perm.begin(), perm.end(), 0);
+    std::shuffle(perm.begin(), perm.end(), rng);
+    std::vector<int> set(perm.begin(), perm.begin() + k);
+    std::vector<int> outside(perm.begin() + k, perm.end());
+
+    IncrementalMST tree(g);
+    check(close(tree.build(set), g.prim_subset(set)), "build", n, k, -1);
+
+    std::uniform_int_distribution<int> coin(0, 1);
+    for (int r = 0; r < rounds; ++r) {
+        const int pos = std::uniform_int_distribution<int>(0, k - 1)(rng);
+        if (tree.is_leaf(pos)) ++leaf_removals;
+        else ++internal_removals;
+
+        // Varias evaluaciones con la misma pos reutilizan MST(S - S[pos])
+        const int tries = std::min<int>(3, outside.size());
+        int j = 0;
+        for (int t = 0; t < tries; ++t) {
+            j = std::uniform_int_distribution<int>(0, outside.size() - 1)(rng);
+            std::vector<int> swapped = set;
+            swapped[pos] = outside[j];
+            const double expected = g.prim_subset(swapped);
+            if (std::isinf(expected)) ++disconnected_sets;
+            check(close(tree.evaluate_swap(pos, outside[j]), expected),
+                  "evaluate_swap", n, k, r);
+        }
+
+        if (coin(rng)) {
+            std::swap(set[pos], outside[j]);
+            const double committed = tree.commit_swap(pos, set[pos]);
+            check(close(committed, g.prim_subset(set)), "commit_swap", n, k, r);
+            check(close(tree.weight(), committed), "weight tras commit_swap", n, k, r);
+            check(tree.vertices() == set, "vertices tras commit_swap", n, k, r);
+        }
+    }
+}
+
+int main() {
+    std::mt19937 rng(2024);
+
+    for (int n : {8, 40, 90}) {
+        for (int k : {2, 3, 5, n / 2, n - 1}) {
+            run_swaps(complete_graph(n, 4, rng), k, 200, rng);
+            run_swaps(complete_graph(n, 1000, rng), k, 200, rng);
+            run_swaps(sparse_graph(n, k, rng), k, 200, rng);
+            run_swaps(sparse_graph(n, k, rng, 2), k, 200, rng);
+        }
+    }
+
+    if (leaf_removals == 0 || internal_removals == 0) {
+        std::fprintf(stderr, "FALLA: no se probaron remociones de hojas e internas (%ld, %ld)\n",
+                     leaf_removals, internal_removals);
+        ++failures;
+    }
+
+    if (disconnected_sets == 0) {
+        std::fprintf(stderr, "FALLA: no se probaron conjuntos desconectados\n");
+        ++failures;
+    }
+
+    if (failures == 0)
+        std::printf("test_incremental_mst: OK (%ld hojas, %ld internos)\n",
+                    leaf_removals, internal_removals);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,132 @@
+#include "../include/philox.hpp"
+#include <cstdio>
+#include <vector>
+
+/**
+ * Pruebas de Philox4x32-10:
+ *   - vectores de respuesta conocida (KAT) de Random123 (kat_vectors)
+ *   - generate() entrega los mismos enteros que llamadas repetidas a operator()
+ *   - seek() reproduce un paso sin importar lo que se extrajo antes
+ */
+
+static int failures = 0;
+
+static void check(bool ok, const char* what) {
+    if (!ok) {
+        std::fprintf(stderr, "FALLA: %s\n", what);
+        ++failures;
+    }
+}
+
+// --- KAT ---
+
+struct Kat {
+    std::array<std::uint32_t, 4> ctr;
+    std::array<std::uint32_t, 2> key;
+    std::array<std::uint32_t, 4> expected;
+};
+
+static void test_kat() {
+    const Kat kats[] = {
+        {{0x00000000u, 0x00000000u, 0x00000000u, 0x00000000u},
+         {0x00000000u, 0x00000000u},
+         {0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u}},
+        {{0xffffffffu, 0xffffffffu, 0xffffffffu, 0xffffffffu},
+         {0xffffffffu, 0xffffffffu},
+         {0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu}},
+        {{0x243f6a88u, 0x85a308d3u, 0x13198a2eu, 0x03707344u},
+         {0xa4093822u, 0x299f31d0u},
+         {0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u}},
+    };
+    for (const Kat& k : kats)
+        check(Philox::philox4x32(k.key, k.ctr) == k.expected, "KAT de Random123");
+
+    // El flujo del generador es philox4x32 con contador (bloque, paso)
+    Philox rng(0xa4093822u, 0x299f31d0u);
+    rng.seek((std::uint64_t(0x03707344u) << 32) | 0x13198a2eu);
+    const auto block0 = Philox::philox4x32({0xa4093822u, 0x299f31d0u},
+                                           {0, 0, 0x13198a2eu, 0x03707344u});
+    for (int i = 0; i < 4; ++i)
+        check(rng() == block0[i], "operator() sigue el contador (bloque, paso)");
+}
+
+// --- generate() contra operator() ---
+
+static void test_generate() {
+    // Prefijos que dejan el búfer a medias y tamaños que cruzan el lote de 32
+    const std::size_t prefixes[] = {0, 1, 3, 4, 5};
+    const std::size_t counts[] = {0, 1, 7, 31, 32, 33, 64, 100, 1000};
+
+    for (std::size_t pre : prefixes) {
+        for (std::size_t count : counts) {
+            Philox a(17, 3), b(17, 3);
+            a.seek(42);
+            b.seek(42);
+            for (std::size_t i = 0; i < pre; ++i) {
+                a();
+                b();
+            }
+
+            std::vector<std::uint32_t> batch(count);
+            a.generate(batch.data(), count);
+            bool same = true;
+            for (std::size_t i = 0; i < count; ++i)
+                same &= batch[i] == b();
+            check(same, "generate() == operator() repetido");
+
+            // Después del lote ambos siguen en el mismo punto del flujo
+            check(a() == b(), "generate() deja el generador en el mismo punto");
+        }
+    }
+}
+
+// --- seek() ---
+
+static void test_seek() {
+    Philox a(5, 9), b(5, 9);
+    a.seek(1000);
+    std::uint32_t first[10];
+    for (auto& x : first) x = a();
+
+    b.seek(3);
+    for (int i = 0; i < 57; ++i) b();
+    b.seek(1000);
+    bool same = true;
+    for (auto x : first) same &= x == b();
+    check(same, "seek() reproduce el paso");
+
+    // Claves distintas dan flujos distintos
+    Philox c(5, 10);
+    c.seek(1000);
+    check(c() != first[0], "streams distintos dan flujos distintos");
+}
+
+// --- below() y uniform01() ---
+
+static void test_ranges() {
+    Philox rng(1, 2);
+    bool in_range = true;
+    for (std::uint32_t n : {1u, 2u, 3u, 7u, 1000u, 0x80000001u}) {
+        rng.seek(n);
+        for (int i = 0; i < 1000; ++i)
+            in_range &= rng.below(n) < n;
+    }
+    check(in_range, "below(n) < n");
+
+    bool unit = true;
+    for (int i = 0; i < 1000; ++i) {
+        double u = rng.uniform01();
+        unit &= u >= 0.0 && u < 1.0;
+    }
+    check(unit, "uniform01() en [0, 1)");
+}
+
+int main() {
+    test_kat();
+    test_generate();
+    test_seek();
+    test_ranges();
+
+    if (failures == 0) std::printf("test_philox: OK\n");
+    return failures == 0 ? 0 : 1;
+}
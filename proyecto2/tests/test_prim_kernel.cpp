@@ -0,0 +1,144 @@
+#include "../include/prim_kernel.hpp"
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <vector>
+
+/**
+ * Equivalencia de los núcleos de Prim (escalar, AVX2, AVX-512) en double y
+ * float: con cada implementación forzada por set_isa, relax_argmin y
+ * relax_argmin_parent deben dar exactamente lo mismo que una referencia
+ * secuencial (key, par y el índice del primer mínimo), con empates,
+ * infinitos y tamaños alrededor del ancho de los vectores. Las
+ * implementaciones que el CPU no soporta se omiten.
+ */
+
+static int failures = 0;
+
+template <typename T>
+struct Case {
+    std::vector<T> row;
+    std::vector<int> ids;
+    std::vector<T> key;
+    std::vector<int> par;
+};
+
+// --- Referencia ---
+
+template <typename T>
+static int reference(const Case<T>& c, std::vector<T>& key, std::vector<int>& par, int u) {
+    key = c.key;
+    par = c.par;
+    const int r = key.size();
+    int j = 0;
+    for (int t = 0; t < r; ++t) {
+        if (c.row[c.ids[t]] < key[t]) {
+            key[t] = c.row[c.ids[t]];
+            par[t] = u;
+        }
+        if (key[t] < key[j]) j = t;
+    }
+    return j;
+}
+
+// --- Casos ---
+
+// Pesos de un rango chico (muchos empates) con una fracción de infinitos
+template <typename T>
+static T weight(std::mt19937& rng, int levels, int inf_one_in) {
+    if (rng() % inf_one_in == 0) return std::numeric_limits<T>::infinity();
+    return T(rng() % levels) / T(4);
+}
+
+template <typename T>
+static Case<T> random_case(std::mt19937& rng, int r, int levels, int inf_one_in) {
+    Case<T> c;
+    const int n = r + rng() % 64;
+    c.row.resize(n);
+    for (auto& w : c.row) w = weight<T>(rng, levels, inf_one_in);
+    c.ids.resize(r);
+    for (auto& x : c.ids) x = rng() % n;
+    c.key.resize(r);
+    for (auto& k : c.key) k = weight<T>(rng, levels, inf_one_in);
+    c.par.assign(r, -1);
+    return c;
+}
+
+template <typename T>
+static Case<T> all_infinite(int r) {
+    const T inf = std::numeric_limits<T>::infinity();
+    Case<T> c;
+    c.row.assign(r, inf);
+    c.ids.resize(r);
+    for (int t = 0; t < r; ++t) c.ids[t] = t;
+    c.key.assign(r, inf);
+    c.par.assign(r, -1);
+    return c;
+}
+
+// --- Comparación ---
+
+template <typename T>
+static void compare(const Case<T>& c, const char* isa, const char* type) {
+    const int r = c.key.size();
+    const int u = 7;
+    std::vector<T> expected_key;
+    std::vector<int> expected_par;
+    const int expected = reference(c, expected_key, expected_par, u);
+
+    std::vector<T> key = c.key;
+    int j = prim_kernel::relax_argmin(c.row.data(), c.ids.data(), key.data(), r);
+    if (j != expected || key != expected_key) {
+        std::fprintf(stderr, "FALLA: relax_argmin %s/%s r=%d: %d en vez de %d\n",
+                     isa, type, r, j, expected);
+        ++failures;
+    }
+
+    key = c.key;
+    std::vector<int> par = c.par;
+    j = prim_kernel::relax_argmin_parent(c.row.data(), c.ids.data(), key.data(),
+                                         par.data(), u, r);
+    if (j != expected || key != expected_key || par != expected_par) {
+        std::fprintf(stderr, "FALLA: relax_argmin_parent %s/%s r=%d: %d en vez de %d\n",
+                     isa, type, r, j, expected);
+        ++failures;
+    }
+}
+
+template <typename T>
+static void run(const char* isa, const char* type) {
+    std::mt19937 rng(99);
+
+    // Todos los tamaños hasta cuatro vectores de AVX-512 en float, y mayores
+    for (int r = 1; r <= 80; ++r) {
+        compare(all_infinite<T>(r), isa, type);
+        for (int rep = 0; rep < 20; ++rep) {
+            compare(random_case<T>(rng, r, 3, 4), isa, type);    // casi todo empatado
+            compare(random_case<T>(rng, r, 200, 10), isa, type);
+        }
+    }
+    for (int rep = 0; rep < 200; ++rep)
+        compare(random_case<T>(rng, 81 + rng() % 1000, 50, 5), isa, type);
+}
+
+int main() {
+    int tested = 0;
+    for (const char* isa : {"scalar", "avx2", "avx512"}) {
+        if (!prim_kernel::set_isa(isa)) {
+            std::printf("test_prim_kernel: %s no soportado, se omite\n", isa);
+            continue;
+        }
+        run<double>(isa, "double");
+        run<float>(isa, "float");
+        ++tested;
+    }
+    prim_kernel::set_isa("auto");
+
+    if (prim_kernel::set_isa("sse9")) {
+        std::fprintf(stderr, "FALLA: set_isa aceptó un nombre inexistente\n");
+        ++failures;
+    }
+
+    if (failures == 0) std::printf("test_prim_kernel: OK (%d implementaciones)\n", tested);
+    return failures == 0 ? 0 : 1;
+}